@@ -18,20 +18,38 @@
 #define CHARSETALTERNATE    0x5000      // Base address for alternate charset
 #define SCREENMAPBASE       0x5800      // Base address for screen map
 #define MEMORYLIMIT         0xCFFF      // Upper memory limit address for address map
+#define SCREENMAPMAXROWS    306         // Maximum canvas height fitting in VDC memory at minimum width
+#define SCREENMAPVDCLIMIT   0xBFFF      // Maximum size of screen map stored in VDC memory above the fixed regions
 #define OVERLAYBANK1        0xD000      // Start address overlay storage bank 1
+#define KEYBUFFER           0x034A      // Kernal keyboard buffer
+#define KEYBUFFERCOUNT      0x00D0      // Number of keys pending in kernal keyboard buffer
+#define JIFFYCLOCK          0x00A0      // Kernal jiffy clock, high byte first
+
+/* REU memory addresses mapping */
+#define REUBANK_OVERLAY     0           // REU bank for overlays and help screens
+#define REUHELPSCREENS      0x6400      // Start address help screens in REU, after the overlays
+#define REUHELPSIZE         0x1000      // Space per help screen in REU
+#define REUBANK_UNDO        1           // REU bank for undo buffer
+#define REUUNDOSTART        0x0000      // Start address undo journal in REU
+#define REUUNDOEND          0xFFFF      // End address undo journal in REU (exclusive, as 0 would equal the start)
+
+// Resize anchor flags
+#define RESIZE_ANCHORRIGHT  1           // Keep content at right edge, grow or shrink at the left
+#define RESIZE_ANCHORBOTTOM 2           // Keep content at bottom edge, grow or shrink at the top
 
 /* Global variables */
 
 // Overlay data struct
-#define OVERLAYNUMBER       4           // Number of overlays
+#define OVERLAYNUMBER       5           // Number of overlays
 #define OVERLAYSIZE         0x1400      // Overlay size (align with config)
 #define OVERLAYLOAD         0xAC00      // Overlay load address (align with config=0xC000-OVERLAYSIZE)
+#define OVERLAYREU          0xFF        // Overlay bank value for overlays stored in REU
 struct OverlayStruct
 {
     unsigned char bank;
     unsigned int address;
 };
-extern struct OverlayStruct overlaydata[4];
+extern struct OverlayStruct overlaydata[5];
 extern unsigned char overlay_active;
 
 //Window data
@@ -51,25 +69,41 @@ extern unsigned char pulldownmenunumber;
 extern char menubartitles[4][12];
 extern unsigned char menubarcoords[4];
 extern unsigned char pulldownmenuoptions[5];
-extern char pulldownmenutitles[5][5][16];
+extern char pulldownmenutitles[5][6][16];
 
 // Undo data
 extern unsigned char vdcmemory;
 extern unsigned char undoenabled;
-extern unsigned int undoaddress;
-extern unsigned char undonumber;
+#define UNDOSLOTS           128         // Maximum number of undo steps in journal index (power of 2)
+#define UNDOCHUNK           128         // Maximum length of a row part encoded at once
+#define UNDOHEADER          8           // Length of undo record header: row, column, width, height
+#define UNDOIDLE            60          // Jiffies without edit that end an undo transaction
 extern unsigned char undo_undopossible;
 extern unsigned char undo_redopossible;
-struct UndoStruct
+extern unsigned int undostart;
+extern unsigned int undoend;
+extern unsigned int canvasbase;
+extern unsigned char reubanks;
+extern unsigned char undoinreu;
+struct StatusBarCache
 {
-    unsigned int address;
-    unsigned char ystart;
-    unsigned char xstart;
-    unsigned char height;
-    unsigned char width;
-    unsigned char redopresent;
+    unsigned char valid;
+    char mode[11];
+    unsigned int xpos;
+    unsigned int ypos;
+    unsigned char screencode;
+    unsigned char altchar;
+    unsigned char color;
+    unsigned char reverse;
+    unsigned char underline;
+    unsigned char blink;
 };
-extern struct UndoStruct Undo[41];
+extern struct StatusBarCache statusbarcache;
+
+// Hardware scrolled canvas data
+extern unsigned char canvasenabled;
+extern unsigned char canvasactive;
+extern unsigned char canvasdirty;
 
 // Menucolors
 extern unsigned char mc_mb_normal;
@@ -95,6 +129,21 @@ extern unsigned int yoffset;
 extern unsigned int screenwidth;
 extern unsigned int screenheight;
 extern unsigned int screentotal;
+extern unsigned int screenmap_rowaddress[SCREENMAPMAXROWS];
+extern unsigned int screenmap_attroffset;
+extern unsigned int screenpitch;
+extern unsigned char mapalign;
+extern unsigned char screenmapbank;
+extern unsigned int screenmapbase;
+extern unsigned char monochrome;
+
+// Screen map address macros via row address table
+// A monochrome map has no attribute plane, all cells are shown with VDC_fillattribute
+#define SCREENMAP_SCREENADDR(row,col)   (screenmap_rowaddress[row]+(col))
+#define SCREENMAP_ATTRADDR(row,col)     (screenmap_rowaddress[row]+(col)+screenmap_attroffset)
+#define SCREENMAP_PLANES                ((monochrome)? 1 : 2)
+#define SCREENMAP_SIZE                  (screenmap_attroffset+((monochrome)? 0 : screenpitch*screenheight))
+#define SCREENMAP_VIEWATTR              ((monochrome)? 0 : screenmap_attroffset)
 extern unsigned char screenbackground;
 extern unsigned char plotscreencode;
 extern unsigned char plotcolor;
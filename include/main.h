@@ -10,28 +10,76 @@ void windowsave(unsigned char ypos, unsigned char height, unsigned char loadsysc
 void windowrestore(unsigned char restorealtcharset);
 void windownew(unsigned char xpos, unsigned char ypos, unsigned char height, unsigned char width, unsigned char loadsyscharset);
 void menuplacebar();
+void menuplaceoption(unsigned char xpos, unsigned char ypos, char* title, unsigned char leadchar, unsigned char attribute);
 unsigned char menupulldown(unsigned char xpos, unsigned char ypos, unsigned char menunumber, unsigned char escapable);
 unsigned char menumain();
 unsigned char areyousure(char* message, unsigned char syscharset);
 void fileerrormessage(unsigned char error, unsigned char syscharset);
 void messagepopup(char* message, unsigned char syscharset);
-unsigned int screenmap_screenaddr(unsigned char row, unsigned char col, unsigned int width);
-unsigned int screenmap_attraddr(unsigned char row, unsigned char col, unsigned int width, unsigned int height);
-void screenmapplot(unsigned char row, unsigned char col, unsigned char screencode, unsigned char attribute);
+void screenmap_rowtable();
+unsigned char screenmap_peek(unsigned int address);
+void screenmap_poke(unsigned int address, unsigned char value);
+unsigned char screenmap_peekattr(unsigned int row, unsigned int col);
+void screenmap_pokeattr(unsigned int row, unsigned int col, unsigned char attribute);
+unsigned char screenmap_storage(unsigned int width, unsigned int height);
+void screenmap_setstorage(unsigned char bank);
+void screenmap_setpacked();
+void screenmap_settables();
+unsigned char screenmap_setlayout(unsigned char aligned);
+void screenmapplot(unsigned int row, unsigned int col, unsigned char screencode, unsigned char attribute);
 void placesignature();
+void screenmap_resize(unsigned int newwidth, unsigned int newheight, unsigned char anchor);
+unsigned char screenmap_setmonochrome(unsigned char mono);
+void screenmap_resizepacked(unsigned int newwidth, unsigned int newheight, unsigned char anchor);
 void screenmapfill(unsigned char screencode, unsigned char attribute);
 void cursormove(unsigned char left, unsigned char right, unsigned char up, unsigned char down);
-void undo_new(unsigned char row, unsigned char col, unsigned char width, unsigned char height);
+void cursormovesteps(unsigned char direction, unsigned char steps);
+unsigned char cursorkeycount(unsigned char key);
+void undo_journalcopy(unsigned char command, unsigned int undoaddr, unsigned int address, unsigned char bank, unsigned int length);
+void undo_mapcopy(unsigned char write, unsigned int mapaddr, unsigned char* buffer, unsigned char length);
+void undo_putbyte(unsigned char value);
+void undo_flush();
+unsigned char undo_getbyte();
+void undo_encode(unsigned char length);
+unsigned char undo_decode(unsigned char length);
+unsigned int undo_mapaddress(unsigned char plane, unsigned int row, unsigned int col);
+void undo_setflags();
+void undo_reset(unsigned int start, unsigned int end);
+void undo_dropoldest();
+unsigned char undo_alloc(unsigned int row, unsigned int col, unsigned int width, unsigned int height);
+void undo_new(unsigned int row, unsigned int col, unsigned int width, unsigned int height);
+void undo_close();
+void undo_apply(unsigned char slot);
 void undo_performundo();
+void undo_txcapture(unsigned char x);
+void undo_begin(unsigned int row, unsigned int col);
+void undo_end();
 void undo_escapeundo();
 void undo_performredo();
 void helpscreen_load(unsigned char screennumber);
+void plotmovesteps(unsigned char direction, unsigned char steps);
 void plotmove(unsigned char direction);
+void plotmovekey(unsigned char key);
 void change_plotcolor(unsigned char newval);
+void statusbar_dec(char* text, unsigned int value, unsigned char digits);
+void statusbar_hex(char* text, unsigned char value);
+void statusbar_flag(unsigned char col, unsigned char flag, unsigned char* cached, char* text);
+void statusbarfields();
 void printstatusbar();
 void initstatusbar();
 void hidestatusbar();
 void togglestatusbar();
+void viewportrefresh();
+void dirty_mark(unsigned int row, unsigned int col, unsigned int width, unsigned int height);
+void dirty_markall();
+unsigned char dirty_refresh();
+void canvas_configure();
+void canvas_relayout();
+void canvas_setview();
+void canvas_show();
+void canvas_hide(unsigned char changecanvas);
+void scrollviewport(unsigned char direction);
+void scrollviewportsteps(unsigned char direction, unsigned char steps);
 void showchareditfield(unsigned char stdoralt);
 unsigned int charaddress(unsigned char screencode, unsigned char stdoralt, unsigned char vdcormem);
 void showchareditgrid(unsigned int screencode, unsigned char stdoralt);
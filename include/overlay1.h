@@ -6,6 +6,6 @@ void colorwrite();
 void palette_draw();
 void palette_returnscreencode();
 void palette();
-void resizewidth();
+void resizecanvas(unsigned char height);
 
 #endif // __OVERLAY1_H_
\ No newline at end of file
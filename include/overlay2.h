@@ -1,10 +1,12 @@
 #ifndef __OVERLAY2_H_
 #define __OVERLAY2_H_
 
-void plotvisible(unsigned char row, unsigned char col, unsigned char setorrestore);
+void plotvisible(unsigned int row, unsigned int col, unsigned char setorrestore);
 void lineandbox(unsigned char draworselect);
 void movemode();
+void select_clear(unsigned int row, unsigned int col, unsigned int width, unsigned int height);
+void select_clearsource(unsigned int destrow, unsigned int destcol);
+void select_transform(unsigned char andmask, unsigned char ormask, unsigned char xormask, const unsigned char* lut);
 void selectmode();
-void resizeheight();
 
 #endif // __OVERLAY2_H_
\ No newline at end of file
@@ -0,0 +1,15 @@
+#ifndef __OVERLAY5_H_
+#define __OVERLAY5_H_
+
+int chooseidandfilename(char* headertext, unsigned char maxlen);
+unsigned char checkiffileexists(char* filetocheck, unsigned char id);
+unsigned char screenmap_loadfile(char* name, unsigned int newwidth, unsigned int newheight, unsigned char mono);
+unsigned char screenmap_savefile(char* name);
+void loadscreenmap();
+void savescreenmap();
+void saveproject();
+void loadproject();
+void loadcharset(unsigned char stdoralt);
+void savecharset(unsigned char stdoralt);
+
+#endif // __OVERLAY5_H_
\ No newline at end of file
@@ -64,6 +64,65 @@ extern unsigned char bankconfig[4];
 #define SCROLL_DOWN             0x04
 #define SCROLL_UP               0x08
 
+// Defines for VDC command list
+#define VDC_CMDLISTSIZE         256   // Size of command list buffer
+#define VDC_CMD_END             0x00  // End of list
+#define VDC_CMD_SETREG          0x01  // Register, value
+#define VDC_CMD_FILL            0x02  // Address, value, length-1
+#define VDC_CMD_PLOT            0x03  // Address, value
+#define VDC_CMD_STRING          0x04  // Address, length-1, bytes
+#define VDC_CMD_COPY            0x05  // Address, length-1, source address in bank 0
+#define VDC_CMD_BLOCKCOPY       0x06  // Destination address, source address, length
+extern unsigned char VDC_cmdlist[VDC_CMDLISTSIZE];
+extern unsigned int VDC_cmdlength;
+
+// Defines and data for vertical blank synchronized refresh scheduler
+#define VDC_REFRESHJOBS         4     // Maximum number of queued refresh jobs
+struct VDC_RefreshJob
+{
+    unsigned int sourcebase;
+    unsigned char sourcebank;
+    unsigned int sourcepitch;
+    unsigned int sourceattroffset;
+    unsigned int sourcexoffset;
+    unsigned int sourceyoffset;
+    unsigned char xcoord;
+    unsigned char ycoord;
+    unsigned char viewwidth;
+    unsigned char viewheight;
+};
+extern unsigned char VDC_refreshframes;
+extern unsigned char VDC_fillattribute;
+
+// Defines and data for VDC memory allocator
+#define VDC_MEMREGIONS          8     // Maximum number of named VDC memory regions
+#define VDC_BANKVDC             0xff  // Pseudo bank number for data stored in VDC memory instead of a CPU bank
+#define VDC_ROWBUFFER           80    // Size of buffer for read-modify-write of VDC memory
+struct VDC_MemRegion
+{
+    char* name;
+    unsigned int address;
+    unsigned int size;
+};
+extern struct VDC_MemRegion VDC_memregion[VDC_MEMREGIONS];
+extern unsigned char VDC_memregions;
+extern unsigned int VDC_memfree;
+
+// REU (17xx RAM Expansion Unit) controller registers and commands
+#define REU_STATUS              0xDF00  // Status register
+#define REU_COMMAND             0xDF01  // Command register
+#define REU_C128ADDRL           0xDF02  // C128 address low byte
+#define REU_C128ADDRH           0xDF03  // C128 address high byte
+#define REU_REUADDRL            0xDF04  // REU address low byte
+#define REU_REUADDRH            0xDF05  // REU address high byte
+#define REU_REUBANK             0xDF06  // REU bank
+#define REU_LENGTHL             0xDF07  // Transfer length low byte
+#define REU_LENGTHH             0xDF08  // Transfer length high byte
+#define REU_ADDRCONTROL         0xDF0A  // Address control, 0 to increase both addresses
+#define REU_STASH               0x90    // Execute at once, C128 to REU
+#define REU_FETCH               0x91    // Execute at once, REU to C128
+#define REU_MAXBANKS            8       // Maximum number of 64KB banks detected (1750)
+
 // Variables in core Functions
 extern unsigned char VDC_regadd;
 extern unsigned char VDC_regval;
@@ -78,11 +137,20 @@ extern unsigned char VDC_tmp1;
 extern unsigned char VDC_tmp2;
 extern unsigned char VDC_tmp3;
 extern unsigned char VDC_tmp4;
+extern unsigned int VDC_attroffset;
+extern unsigned int VDC_linestride;
+extern unsigned int VDC_destpitch;
+extern unsigned int VDC_rows;
+extern unsigned char VDC_stagebuffer[256];
+extern unsigned int VDC_displaybase;
+extern unsigned int VDC_rowaddress[25];
+
+// VDC address of row and column of displayed screen via row address table
+#define VDC_ROWCOLADDRESS(row,col)  (VDC_rowaddress[row]+(col))
 
 // Import assembly core Functions
 void VDC_ReadRegister_core();
 void VDC_WriteRegister_core();
-void VDC_Poke_core();
 void VDC_Peek_core();
 void VDC_DetectVDCMemSize_core();
 void VDC_SetExtendedVDCMemSize();
@@ -95,53 +163,96 @@ void VDC_CopyMemToVDC_core();
 void VDC_CopyVDCToMem_core();
 void VDC_RedefineCharset_core();
 void VDC_FillArea_core();
+void VDC_FillBlock_core();
 void VDC_CopyViewPortToVDC_core();
 void VDC_ScrollCopy_core();
+void VDC_RunCommands_core();
+void VDC_WaitVBlank();
 
 void SetLoadSaveBank_core();
-void POKEB_core();
-void PEEKB_core();
 void BankMemCopy_core();
 void BankMemSet_core();
+void BankRectCopy_core();
+void BankRectSet_core();
+void BankRectTransform_core();
 
 // Function Prototypes
 unsigned char VDC_ReadRegister(unsigned char registeraddress);
 void VDC_WriteRegister(unsigned char registeraddress, unsigned char registervalue);
 unsigned char VDC_DetectVDCMemSize();
-void VDC_Poke(int address,  unsigned char value);
+void __fastcall__ VDC_Poke(int address,  unsigned char value);
 unsigned char VDC_Peek(int address);
 unsigned char VDC_DetectVDCMemSize();
 void VDC_SetExtendedVDCMemSize();
+void VDC_MemInit(unsigned char memorysize);
+void VDC_MemReset();
+unsigned int VDC_MemAlloc(char* name, unsigned int size);
+unsigned int VDC_MemAllocRest(char* name);
 void VDC_SetCursorMode(unsigned char cursorMode);
 void VDC_MemCopy(unsigned int sourceaddr, unsigned int destaddr, unsigned int length);
+void VDC_MemMove(unsigned int sourceaddr, unsigned int destaddr, unsigned int length);
+void VDC_RectCopy(unsigned int source, unsigned int sourcepitch, unsigned int dest, unsigned int destpitch, unsigned int width, unsigned int height);
+void VDC_RectSet(unsigned int address, unsigned int pitch, unsigned char value, unsigned int width, unsigned int height);
+void VDC_RectTransform(unsigned int address, unsigned int pitch, unsigned int width, unsigned int height);
 void VDC_HChar(unsigned char row, unsigned char col, unsigned char character, unsigned char length, unsigned char attribute);
 void VDC_VChar(unsigned char row, unsigned char col, unsigned char character, unsigned char length, unsigned char attribute);
 void VDC_CopyMemToVDC(unsigned int vdcAddress, unsigned int memAddress, unsigned char memBank, unsigned int length);
 void VDC_CopyVDCToMem(unsigned int vdcAddress, unsigned int memAddress, unsigned char memBank, unsigned int length);
 void VDC_RedefineCharset(unsigned int source, unsigned char sourcebank, unsigned int dest, unsigned char lengthinchars);
 void VDC_FillArea(unsigned char row, unsigned char col, unsigned char character, unsigned char length, unsigned char height, unsigned char attribute);
+void VDC_FillBlock(unsigned int address, unsigned char value, unsigned int length);
 void VDC_Init(void);
 void VDC_Exit(void);
-unsigned char VDC_PetsciiToScreenCode(unsigned char p);
-unsigned char VDC_PetsciiToScreenCodeRvs(unsigned char p);
+
+// PETSCII and screencode translation via tables in vdc_core_assembly.s
+extern const unsigned char VDC_PetsciiToScreenCodeTable[256];
+extern const unsigned char VDC_PetsciiToScreenCodeRvsTable[256];
+unsigned char __fastcall__ VDC_PetsciiToScreenCode(unsigned char p);
+unsigned char __fastcall__ VDC_PetsciiToScreenCodeRvs(unsigned char p);
+void __fastcall__ VDC_TranslateBuffer(const unsigned char* table, unsigned char* buffer, unsigned int length);
+
 unsigned int VDC_RowColToAddress(unsigned char row, unsigned char col);
+void VDC_SetDisplay(unsigned int textaddress, unsigned int attraddress, unsigned int linestride);
 void VDC_BackColor(unsigned char color);
 unsigned char VDC_CursorAt(unsigned char row, unsigned char col);
 unsigned char VDC_PrintAt(unsigned char row, unsigned char col, char *text, unsigned char attribute);
 unsigned int VDC_LoadCharset(char* filename, unsigned char deviceid, unsigned int source, unsigned char sourcebank, unsigned char stdoralt);
 unsigned int VDC_LoadScreen(char* filename, unsigned char deviceid, unsigned int source, unsigned char sourcebank);
 unsigned char VDC_SaveScreen(char* filename, unsigned char deviceid, unsigned int bufferaddress, unsigned char bufferbank);
+unsigned int VDC_LoadStream(char* filename, unsigned char deviceid, unsigned int vdcaddress, unsigned int maxlength);
+unsigned char VDC_SaveStream(char* filename, unsigned char deviceid, unsigned int vdcaddress, unsigned int length, unsigned int loadaddress);
 unsigned char VDC_Attribute(unsigned char textcolor, unsigned char blink, unsigned char underline, unsigned char reverse, unsigned char alternate);
-void VDC_Plot(unsigned char row, unsigned char col, unsigned char screencode, unsigned char attribute);
+void __fastcall__ VDC_Plot(unsigned char row, unsigned char col, unsigned char screencode, unsigned char attribute);
 void VDC_PlotString(unsigned char row, unsigned char col, char* plotstring, unsigned char length, unsigned char attribute);
-void VDC_CopyViewPortToVDC(unsigned int sourcebase, unsigned char sourcebank, unsigned int sourcewidth, unsigned int sourceheight, unsigned int sourcexoffset, unsigned int sourceyoffset, unsigned char xcoord, unsigned char ycoord, unsigned char viewwidth, unsigned char viewheight );
-void VDC_ScrollCopy(unsigned int sourcebase, unsigned char sourcebank, unsigned int sourcewidth, unsigned int sourceheight, unsigned int sourcexoffset, unsigned int sourceyoffset, unsigned char xcoord, unsigned char ycoord, unsigned char viewwidth, unsigned char viewheight, unsigned char direction);
+void VDC_CopyViewPortToVDC(unsigned int sourcebase, unsigned char sourcebank, unsigned int sourcepitch, unsigned int sourceattroffset, unsigned int sourcexoffset, unsigned int sourceyoffset, unsigned char xcoord, unsigned char ycoord, unsigned char viewwidth, unsigned char viewheight );
+void VDC_FillViewPortAttr(unsigned int address, unsigned char viewwidth, unsigned char viewheight);
+void VDC_ScrollCopy(unsigned int sourcebase, unsigned char sourcebank, unsigned int sourcepitch, unsigned int sourceattroffset, unsigned int sourcexoffset, unsigned int sourceyoffset, unsigned char xcoord, unsigned char ycoord, unsigned char viewwidth, unsigned char viewheight, unsigned char direction);
+void VDC_RefreshQueue(unsigned int sourcebase, unsigned char sourcebank, unsigned int sourcepitch, unsigned int sourceattroffset, unsigned int sourcexoffset, unsigned int sourceyoffset, unsigned char xcoord, unsigned char ycoord, unsigned char viewwidth, unsigned char viewheight);
+void VDC_RefreshRun();
+void VDC_ScrollLines(unsigned int sourceaddr, unsigned int destaddr, unsigned char lines, unsigned char length, int linestep);
 void VDC_ScrollMove(unsigned char xcoord, unsigned char ycoord, unsigned char viewwidth, unsigned char viewheight, unsigned char direction);
+void VDC_CmdRun();
+void VDC_CmdRoom(unsigned char length);
+void VDC_CmdSetReg(unsigned char registeraddress, unsigned char registervalue);
+void VDC_CmdFill(unsigned int address, unsigned char value, unsigned char length);
+void VDC_CmdPoke(unsigned int address, unsigned char value);
+void VDC_CmdString(unsigned int address, unsigned char* data, unsigned char length);
+void VDC_CmdCopy(unsigned int address, unsigned int memaddress, unsigned char length);
+void VDC_CmdBlockCopy(unsigned int destaddr, unsigned int sourceaddr, unsigned char length);
+void VDC_CmdPlot(unsigned char row, unsigned char col, unsigned char screencode, unsigned char attribute);
+unsigned char VDC_CmdPrintAt(unsigned char row, unsigned char col, char *text, unsigned char attribute);
+void VDC_CmdFillArea(unsigned char row, unsigned char col, unsigned char character, unsigned char length, unsigned char height, unsigned char attribute);
 
 void SetLoadSaveBank(unsigned char bank);
-void POKEB(unsigned int address, unsigned char bank, unsigned char value);
-unsigned char PEEKB(unsigned int address, unsigned char bank);
-void BankMemCopy(unsigned int source, unsigned char sourcebank, unsigned int dest, unsigned char destbank, unsigned int length);
+unsigned char REU_Detect();
+void REU_Transfer(unsigned char command, unsigned int address, unsigned char bank, unsigned int reuaddress, unsigned char reubank, unsigned int length);
+// Fastcall primitives in vdc_core_assembly.s
+void __fastcall__ POKEB(unsigned int address, unsigned char bank, unsigned char value);
+unsigned char __fastcall__ PEEKB(unsigned int address, unsigned char bank);
+void __fastcall__ BankMemCopy(unsigned int source, unsigned char sourcebank, unsigned int dest, unsigned char destbank, unsigned int length);
 void BankMemSet(unsigned int source, unsigned char sourcebank, unsigned char value, unsigned int length);
+void BankRectCopy(unsigned int source, unsigned int sourcepitch, unsigned int dest, unsigned int destpitch, unsigned char bank, unsigned int width, unsigned int height);
+void BankRectSet(unsigned int address, unsigned int pitch, unsigned char bank, unsigned char value, unsigned int width, unsigned int height);
+void BankRectTransform(unsigned int address, unsigned int pitch, unsigned char bank, unsigned int width, unsigned int height, unsigned char andmask, unsigned char ormask, unsigned char xormask, const unsigned char* lut);
 
 #endif
\ No newline at end of file
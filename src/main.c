@@ -66,13 +66,15 @@ BUT WITHOUT ANY WARRANTY. USE THEM AT YOUR OWN RISK!
 #include <c128.h>
 #include "vdc_core.h"
 #include "defines.h"
+#include "main.h"
 #include "overlay1.h"
 #include "overlay2.h"
 #include "overlay3.h"
 #include "overlay4.h"
+#include "overlay5.h"
 
 // Overlay data
-struct OverlayStruct overlaydata[4];
+struct OverlayStruct overlaydata[5];
 unsigned char overlay_active = 0;
 
 //Window data
@@ -85,13 +87,14 @@ unsigned char menubaroptions = 4;
 unsigned char pulldownmenunumber = 8;
 char menubartitles[4][12] = {"Screen","File","Charset","Information"};
 unsigned char menubarcoords[4] = {1,8,13,21};
-unsigned char pulldownmenuoptions[5] = {5,4,4,2,2};
-char pulldownmenutitles[5][5][16] = {
+unsigned char pulldownmenuoptions[5] = {6,4,4,3,2};
+char pulldownmenutitles[5][6][16] = {
     {"Width:      80 ",
      "Height:     25 ",
      "Background:  0 ",
      "Clear          ",
-     "Fill           "},
+     "Fill           ",
+     "Mono:      Off "},
     {"Save screen    ",
      "Load screen    ",
      "Save project   ",
@@ -101,7 +104,8 @@ char pulldownmenutitles[5][5][16] = {
      "Save standard  ",
      "Save alternate "},
     {"Version/credits",
-     "Exit program   "},
+     "Exit program   ",
+     "Map: Packed    "},
     {"Yes",\
      "No "}
 };
@@ -109,11 +113,35 @@ char pulldownmenutitles[5][5][16] = {
 // Undo data
 unsigned char vdcmemory;
 unsigned char undoenabled = 0;
-unsigned int undoaddress;
-unsigned char undonumber;
 unsigned char undo_undopossible;
 unsigned char undo_redopossible;
-struct UndoStruct Undo[41];
+unsigned int undostart = VDCEXTENDED;
+unsigned int undoend = VDCEXTENDED;
+unsigned int undo_index[UNDOSLOTS];
+unsigned char undo_first, undo_count, undo_position, undo_pending, undo_changed;
+unsigned int undo_tail, undo_raw;
+unsigned char undo_transaction, undo_txwidth;
+unsigned int undo_txrow, undo_txcol, undo_lastedit;
+unsigned int undo_header[4];
+unsigned char undo_buffer[UNDOCHUNK];
+unsigned char undo_delta[UNDOCHUNK];
+unsigned char undo_stream[UNDOCHUNK];
+unsigned int undo_streamaddress;
+unsigned char undo_streamfill, undo_streampos;
+unsigned char reubanks = 0;
+unsigned char undoinreu = 0;
+unsigned char helpscreensinreu = 0;
+unsigned int canvasbase = 0;
+unsigned int canvasregion = 0;
+unsigned int canvassize = 0;
+
+// Dirty region of screen map not yet shown, bounding box with exclusive end (empty if end is 0)
+unsigned int dirty_xstart, dirty_ystart, dirty_xend, dirty_yend;
+
+// Hardware scrolled canvas data
+unsigned char canvasenabled = 0;
+unsigned char canvasactive = 0;
+unsigned char canvasdirty = 1;
 
 // Menucolors
 unsigned char mc_mb_normal = VDC_LGREEN + VDC_A_REVERSE + VDC_A_ALTCHAR;
@@ -139,6 +167,13 @@ unsigned int yoffset;
 unsigned int screenwidth;
 unsigned int screenheight;
 unsigned int screentotal;
+unsigned int screenpitch;
+unsigned char mapalign = 0;
+unsigned char screenmapbank = 1;
+unsigned int screenmapbase = SCREENMAPBASE;
+unsigned int screenmap_rowaddress[SCREENMAPMAXROWS];
+unsigned int screenmap_attroffset;
+unsigned char monochrome = 0;
 unsigned char screenbackground;
 unsigned char plotscreencode;
 unsigned char plotcolor;
@@ -154,6 +189,8 @@ unsigned char visualmap = 0;
 unsigned char favourites[10][2];
 
 char buffer[81];
+const char hexdigits[] = "0123456789ABCDEF";
+struct StatusBarCache statusbarcache;
 char version[22];
 
 // Generic routines
@@ -249,14 +286,14 @@ int textInput(unsigned char xpos, unsigned char ypos, char* str, unsigned char s
             if (idx)
             {
                 --idx;
-                VDC_Plot(ypos, xpos + idx,CH_SPACE,mc_menupopup);
                 for(c = idx; 1; ++c)
                 {
                     unsigned char b = str[c+1];
                     str[c] = b;
-                    VDC_Plot(ypos, xpos+c, b? VDC_PetsciiToScreenCode(b) : CH_SPACE, mc_menupopup);
                     if (b == 0) { break; }
                 }
+                VDC_PrintAt(ypos,xpos+idx,str+idx,mc_menupopup);
+                VDC_Plot(ypos,xpos+c,CH_SPACE,mc_menupopup);
                 gotoxy(xpos+idx,ypos);
             }
             break;
@@ -349,6 +386,9 @@ void initoverlay()
     unsigned int address=OVERLAYBANK0;
     unsigned char destbank=3;
 
+    // Overlays are stored in REU if present, keeping bank 0 and 1 free
+    if(reubanks) { destbank=OVERLAYREU; address=0; }
+
     for(x=0;x<OVERLAYNUMBER;x++)
     {
         // Update load status message
@@ -370,7 +410,13 @@ void initoverlay()
         overlaydata[x].bank=destbank;
         //cprintf("Copy to: %u %4X ",destbank,address);
 
-        if(destbank)
+        if(destbank==OVERLAYREU)
+        {
+            REU_Transfer(REU_STASH,OVERLAYLOAD,0,address,REUBANK_OVERLAY,OVERLAYSIZE);
+            overlaydata[x].address=address;
+            address+=OVERLAYSIZE;
+        }
+        else if(destbank)
         {
             BankMemCopy(OVERLAYLOAD,2,address,destbank-1,OVERLAYSIZE);
             overlaydata[x].address=address;
@@ -404,7 +450,11 @@ void loadoverlay(unsigned char overlay_select)
     if(overlay_select != overlay_active)
     {
         overlay_active = overlay_select;
-        if(overlaydata[overlay_select-1].bank)
+        if(overlaydata[overlay_select-1].bank==OVERLAYREU)
+        {
+            REU_Transfer(REU_FETCH,OVERLAYLOAD,0,overlaydata[overlay_select-1].address,REUBANK_OVERLAY,OVERLAYSIZE);
+        }
+        else if(overlaydata[overlay_select-1].bank)
         {
             BankMemCopy(overlaydata[overlay_select-1].address,overlaydata[overlay_select-1].bank-1,OVERLAYLOAD,2,OVERLAYSIZE);
         }
@@ -461,6 +511,7 @@ void windowrestore(unsigned char restorealtcharset)
        Input: restorealtcharset: request to restore user defined charset if needed enabled (1) or not (0) */
 
     windowaddress = Window[--windownumber].address;
+    statusbarcache.valid = 0;
 
     // Restore characters
     VDC_CopyMemToVDC(Window[windownumber].ypos*80,windowaddress,1,Window[windownumber].height*80);
@@ -496,11 +547,26 @@ void menuplacebar()
 
     unsigned char x;
 
-    VDC_FillArea(0,0,CH_SPACE,80,1,mc_mb_normal);
+    VDC_CmdFillArea(0,0,CH_SPACE,80,1,mc_mb_normal);
     for(x=0;x<menubaroptions;x++)
     {
-        VDC_PrintAt(0,menubarcoords[x],menubartitles[x],mc_mb_normal);
+        VDC_CmdPrintAt(0,menubarcoords[x],menubartitles[x],mc_mb_normal);
     }
+    VDC_CmdRun();
+}
+
+void menuplaceoption(unsigned char xpos, unsigned char ypos, char* title, unsigned char leadchar, unsigned char attribute)
+{
+    /* Function to add a pull down menu option to the VDC command list
+       Input:
+       - xpos, ypos: coordinates of start of option
+       - title: option text
+       - leadchar: screencode in front of the option text
+       - attribute: attribute value for the option */
+
+    VDC_CmdPlot(ypos,xpos,leadchar,attribute);
+    VDC_CmdPrintAt(ypos,xpos+1,title,attribute);
+    VDC_CmdPlot(ypos,xpos+strlen(title)+1,CH_SPACE,attribute);
 }
 
 unsigned char menupulldown(unsigned char xpos, unsigned char ypos, unsigned char menunumber, unsigned char escapable)
@@ -521,16 +587,13 @@ unsigned char menupulldown(unsigned char xpos, unsigned char ypos, unsigned char
     windowsave(ypos, pulldownmenuoptions[menunumber-1],0);
     for(x=0;x<pulldownmenuoptions[menunumber-1];x++)
     {
-        VDC_Plot(ypos+x,xpos,CH_SPACE,mc_pd_normal);
-        VDC_PrintAt(ypos+x,xpos+1,pulldownmenutitles[menunumber-1][x],mc_pd_normal);
-        VDC_Plot(ypos+x,xpos+strlen(pulldownmenutitles[menunumber-1][x])+1,CH_SPACE,mc_pd_normal);
+        menuplaceoption(xpos,ypos+x,pulldownmenutitles[menunumber-1][x],CH_SPACE,mc_pd_normal);
     }
   
     do
     {
-        VDC_Plot(ypos+menuchoice-1,xpos,CH_MINUS,mc_pd_select);
-        VDC_PrintAt(ypos+menuchoice-1,xpos+1,pulldownmenutitles[menunumber-1][menuchoice-1],mc_pd_select);
-        VDC_Plot(ypos+menuchoice-1,xpos+strlen(pulldownmenutitles[menunumber-1][menuchoice-1])+1,CH_SPACE,mc_pd_select);
+        menuplaceoption(xpos,ypos+menuchoice-1,pulldownmenutitles[menunumber-1][menuchoice-1],CH_MINUS,mc_pd_select);
+        VDC_CmdRun();
 
         do
         {
@@ -560,9 +623,7 @@ unsigned char menupulldown(unsigned char xpos, unsigned char ypos, unsigned char
 
         case CH_CURS_DOWN:
         case CH_CURS_UP:
-            VDC_Plot(ypos+menuchoice-1,xpos,CH_SPACE,mc_pd_normal);
-            VDC_PrintAt(ypos+menuchoice-1,xpos+1,pulldownmenutitles[menunumber-1][menuchoice-1],mc_pd_normal);
-            VDC_Plot(ypos+menuchoice-1,xpos+strlen(pulldownmenutitles[menunumber-1][menuchoice-1])+1,CH_SPACE,mc_pd_normal);
+            menuplaceoption(xpos,ypos+menuchoice-1,pulldownmenutitles[menunumber-1][menuchoice-1],CH_SPACE,mc_pd_normal);
             if(key==CH_CURS_UP)
             {
                 menuchoice--;
@@ -604,18 +665,16 @@ unsigned char menumain()
     {
         do
         {
-            VDC_Plot(0,menubarcoords[menubarchoice-1]-1,CH_SPACE,mc_mb_select);
-            VDC_PrintAt(0,menubarcoords[menubarchoice-1],menubartitles[menubarchoice-1],mc_mb_select);
-            VDC_Plot(0,menubarcoords[menubarchoice-1]+strlen(menubartitles[menubarchoice-1]),CH_SPACE,mc_mb_select);
+            menuplaceoption(menubarcoords[menubarchoice-1]-1,0,menubartitles[menubarchoice-1],CH_SPACE,mc_mb_select);
+            VDC_CmdRun();
 
             do
             {
                 key = cgetc();
             } while (key != CH_ENTER && key != CH_CURS_LEFT && key != CH_CURS_RIGHT && key != CH_ESC && key != CH_STOP);
 
-            VDC_Plot(0,menubarcoords[menubarchoice-1]-1,CH_SPACE,mc_mb_normal);
-            VDC_PrintAt(0,menubarcoords[menubarchoice-1],menubartitles[menubarchoice-1],mc_mb_normal);
-            VDC_Plot(0,menubarcoords[menubarchoice-1]+strlen(menubartitles[menubarchoice-1]),CH_SPACE,mc_mb_normal);
+            menuplaceoption(menubarcoords[menubarchoice-1]-1,0,menubartitles[menubarchoice-1],CH_SPACE,mc_mb_normal);
+            VDC_CmdRun();
             
             if(key==CH_CURS_LEFT)
             {
@@ -712,114 +771,531 @@ void messagepopup(char* message, unsigned char syscharset)
 
 // Generic screen map routines
 
+void statusbar_dec(char* text, unsigned int value, unsigned char digits)
+{
+    // Function to write a value as right aligned decimal number of given width, instead of sprintf
+    // A value too wide for the field is shown as a field of asterisks
+
+    unsigned char x = digits;
+
+    text[digits] = 0;
+    do
+    {
+        text[--digits] = '0' + (value % 10);
+        value /= 10;
+    } while (digits && value);
+    while(digits) { text[--digits] = ' '; }
+    if(value) { while(x) { text[--x] = '*'; } }
+}
+
+void statusbar_hex(char* text, unsigned char value)
+{
+    // Function to write a value as two digit hexadecimal number, instead of sprintf
+
+    text[0] = hexdigits[value>>4];
+    text[1] = hexdigits[value & 0x0f];
+    text[2] = 0;
+}
+
+void statusbar_flag(unsigned char col, unsigned char flag, unsigned char* cached, char* text)
+{
+    // Function to add an attribute flag field to the VDC command list if changed
+
+    if(statusbarcache.valid && flag == *cached) { return; }
+    *cached = flag;
+    VDC_CmdPrintAt(24,col,(flag)? text:"   ",mc_menupopup);
+}
+
+void statusbarfields()
+{
+    // Function to add the changed statusbar fields to the VDC command list
+    // Last drawn values are cached, all fields are drawn if the cache is not valid
+
+    unsigned int xpos = screen_col+xoffset;
+    unsigned int ypos = screen_row+yoffset;
+    unsigned char len;
+
+    if(!statusbarcache.valid || strcmp(statusbarcache.mode,programmode))
+    {
+        strcpy(statusbarcache.mode,programmode);
+        strcpy(buffer,programmode);
+        for(len=strlen(buffer);len<10;len++) { buffer[len] = ' '; }
+        buffer[10] = 0;
+        VDC_CmdPrintAt(24,6,buffer,mc_menupopup);
+    }
+    if(!statusbarcache.valid || xpos != statusbarcache.xpos || ypos != statusbarcache.ypos)
+    {
+        statusbarcache.xpos = xpos;
+        statusbarcache.ypos = ypos;
+        // Four digits for x as maps in VDC memory can be over 999 wide, height is at most SCREENMAPMAXROWS
+        statusbar_dec(buffer,xpos,4);
+        buffer[4] = ',';
+        statusbar_dec(buffer+5,ypos,3);
+        VDC_CmdPrintAt(24,22,buffer,mc_menupopup);
+    }
+    if(!statusbarcache.valid || plotscreencode != statusbarcache.screencode || plotaltchar != statusbarcache.altchar)
+    {
+        statusbarcache.screencode = plotscreencode;
+        VDC_CmdPlot(24,36,plotscreencode,(plotaltchar)? mc_menupopup : mc_menupopup-VDC_A_ALTCHAR);
+        statusbar_hex(buffer,plotscreencode);
+        VDC_CmdPrintAt(24,38,buffer,mc_menupopup);
+    }
+    if(!statusbarcache.valid || plotcolor != statusbarcache.color)
+    {
+        statusbarcache.color = plotcolor;
+        VDC_CmdPlot(24,48,CH_SPACE,plotcolor+VDC_A_REVERSE);
+        statusbar_dec(buffer,plotcolor,2);
+        VDC_CmdPrintAt(24,50,buffer,mc_menupopup);
+    }
+    statusbar_flag(54,plotreverse,&statusbarcache.reverse,"REV");
+    statusbar_flag(58,plotunderline,&statusbarcache.underline,"UND");
+    statusbar_flag(62,plotblink,&statusbarcache.blink,"BLI");
+    statusbar_flag(66,plotaltchar,&statusbarcache.altchar,"ALT");
+    statusbarcache.valid = 1;
+}
+
 void printstatusbar()
 {
+    if(screen_row==24) { statusbarcache.valid = 0; return; }
+
+    statusbarfields();
+    VDC_CmdRun();
+}
+
+void initstatusbar()
+{
+    statusbarcache.valid = 0;
     if(screen_row==24) { return; }
 
-    sprintf(buffer,"%-10s",programmode);
-    VDC_PrintAt(24,6,buffer,mc_menupopup);
-    sprintf(buffer,"%3u,%3u",screen_col+xoffset,screen_row+yoffset);
-    VDC_PrintAt(24,22,buffer,mc_menupopup);
-    if(plotaltchar)
+    VDC_CmdFillArea(24,0,CH_SPACE,80,1,mc_menupopup);
+    VDC_CmdPrintAt(24, 0,"Mode:",mc_menupopup);
+    VDC_CmdPrintAt(24,17,"X,Y:",mc_menupopup);
+    VDC_CmdPrintAt(24,31,"Char:",mc_menupopup);
+    VDC_CmdPrintAt(24,41,"Color:",mc_menupopup);
+    VDC_CmdPrintAt(24,73,"F8=Help",mc_menupopup);
+    statusbarfields();
+    VDC_CmdRun();
+}
+
+void hidestatusbar()
+{
+    statusbarcache.valid = 0;
+    VDC_CopyViewPortToVDC(screenmapbase,screenmapbank,screenpitch,SCREENMAP_VIEWATTR,xoffset,yoffset+24,0,24,80,1);
+}
+
+void togglestatusbar()
+{
+    if(screen_row==24) { return; }
+
+    if(showbar)
     {
-        VDC_Plot(24,36,plotscreencode,mc_menupopup);
+        showbar=0;
+        hidestatusbar();
     }
     else
     {
-        VDC_Plot(24,36,plotscreencode,mc_menupopup-VDC_A_ALTCHAR);
+        showbar=1;
+        initstatusbar();
     }
-    sprintf(buffer,"%2X",plotscreencode);
-    VDC_PrintAt(24,38,buffer,mc_menupopup);
-    VDC_Plot(24,48,CH_SPACE,plotcolor+VDC_A_REVERSE);
-    sprintf(buffer,"%2u",plotcolor);
-    VDC_PrintAt(24,50,buffer,mc_menupopup);
-    if(plotreverse)
+}
+
+void viewportrefresh()
+{
+    // Function to refresh the full viewport from the screen map, synchronized to vertical blank
+
+    statusbarcache.valid = 0;
+    dirty_xend = 0;
+    VDC_RefreshQueue(screenmapbase,screenmapbank,screenpitch,SCREENMAP_VIEWATTR,xoffset,yoffset,0,0,80,25);
+    VDC_RefreshRun();
+}
+
+void dirty_mark(unsigned int row, unsigned int col, unsigned int width, unsigned int height)
+{
+    // Function to add a changed rectangle of the screen map to the dirty region
+    // The region is kept as bounding box of all changes since the last refresh
+
+    if(!width || !height) { return; }
+
+    if(!dirty_xend)
     {
-        VDC_PrintAt(24,54,"REV",mc_menupopup);
+        dirty_xstart = col;
+        dirty_ystart = row;
+        dirty_xend = col+width;
+        dirty_yend = row+height;
+        return;
     }
-    else
+    if(col<dirty_xstart) { dirty_xstart = col; }
+    if(row<dirty_ystart) { dirty_ystart = row; }
+    if(col+width>dirty_xend) { dirty_xend = col+width; }
+    if(row+height>dirty_yend) { dirty_yend = row+height; }
+}
+
+void dirty_markall()
+{
+    // Function to mark the full screen map as dirty
+
+    dirty_mark(0,0,screenwidth,screenheight);
+}
+
+unsigned char dirty_refresh()
+{
+    // Function to refresh only the part of the dirty region inside the viewport and clear the region
+    // Returns 1 if the statusbar row was overwritten and the statusbar needs to be redrawn
+
+    unsigned int xstart = dirty_xstart;
+    unsigned int ystart = dirty_ystart;
+    unsigned int xend = dirty_xend;
+    unsigned int yend = dirty_yend;
+
+    dirty_xend = 0;
+    if(xstart<xoffset) { xstart = xoffset; }
+    if(ystart<yoffset) { ystart = yoffset; }
+    if(xend>xoffset+80) { xend = xoffset+80; }
+    if(yend>yoffset+25) { yend = yoffset+25; }
+    if(xstart>=xend || ystart>=yend) { return 0; }
+
+    VDC_RefreshQueue(screenmapbase,screenmapbank,screenpitch,SCREENMAP_VIEWATTR,xstart,ystart,xstart-xoffset,ystart-yoffset,xend-xstart,yend-ystart);
+    VDC_RefreshRun();
+    if(yend<yoffset+25) { return 0; }
+    statusbarcache.valid = 0;
+    return 1;
+}
+
+// Hardware scrolled canvas routines
+
+void canvas_configure()
+{
+    // Function to place canvas copy and undo buffer in VDC memory after canvas size change or toggle
+    // The canvas copy uses the same layout as the screen map in bank 1, undo gets all memory left above it
+    // Undo has to be the last region, as the undo ring wraps at the end of VDC memory
+    // With a REU undo uses a REU bank instead, unless the screen map is in VDC memory
+
+    unsigned int address, size;
+
+    VDC_MemReset();
+    canvasbase = 0;
+    if(screenmapbank == VDC_BANKVDC)
+    {
+        // Screen map in VDC memory is always the first region, so its address does not change
+        screenmapbase = VDC_MemAlloc("Map",SCREENMAP_SIZE);
+    }
+    else if(canvasenabled && !monochrome && screenpitch < 336)
     {
-        VDC_PrintAt(24,54,"   ",mc_menupopup);
+        canvasbase = VDC_MemAlloc("Canvas",SCREENMAP_SIZE);
     }
-    if(plotunderline)
+    canvasregion = canvasbase;
+    canvassize = (canvasbase)? SCREENMAP_SIZE : 0;
+    undoinreu = (reubanks > REUBANK_UNDO && screenmapbank != VDC_BANKVDC);
+    if(undoinreu)
     {
-        VDC_PrintAt(24,58,"UND",mc_menupopup);
+        undo_reset(REUUNDOSTART,REUUNDOEND);
     }
     else
     {
-        VDC_PrintAt(24,58,"   ",mc_menupopup);
+        size = VDC_memfree;
+        address = VDC_MemAllocRest("Undo");
+        if(!address) { size = 0; }
+        undo_reset(address,address+size);                   // End wraps to 0 if undo reaches the end of VDC memory
+    }
+    canvasdirty = 1;
+}
+
+void canvas_relayout()
+{
+    // Function to follow a layout change of the screen map without moving the VDC memory regions,
+    // so the undo journal, which only uses map coordinates, is kept
+    // The canvas copy is only used if the map in its present layout fits in the region allocated for it
+
+    canvasbase = (canvasregion && screenpitch < 336 && SCREENMAP_SIZE <= canvassize)? canvasregion : 0;
+    canvasdirty = 1;
+}
+
+void canvas_setview()
+{
+    // Function to point VDC display to the visible part of the canvas copy
+
+    unsigned int address = canvasbase + (yoffset*screenpitch) + xoffset;
+
+    VDC_SetDisplay(address,address+screenmap_attroffset,screenpitch);
+}
+
+void canvas_show()
+{
+    // Function to switch display to the canvas copy in VDC memory, so scrolling only needs register writes
+    // Needs 64KB VDC memory and a canvas width the row increment register 27 can handle
+
+    if(canvasactive || !canvasbase) { return; }
+
+    if(canvasdirty)
+    {
+        VDC_CopyMemToVDC(canvasbase,screenmapbase,screenmapbank,SCREENMAP_SIZE);
+        canvasdirty = 0;
     }
-    if(plotblink)
+    canvas_setview();
+    canvasactive = 1;
+    if(showbar) { initstatusbar(); }
+    VDC_Plot(screen_row,screen_col,plotscreencode,VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
+    VDC_CursorAt(screen_row,screen_col);
+}
+
+void canvas_hide(unsigned char changecanvas)
+{
+    // Function to switch display back to the standard screen before other modes, menus and popups
+    // Input: changecanvas = 1 if the following action can change the screen map
+
+    if(canvasactive)
+    {
+        // Restore the canvas copy cells used by the statusbar and cursor
+        if(showbar) { hidestatusbar(); }
+        VDC_Plot(screen_row,screen_col,screenmap_peek(SCREENMAP_SCREENADDR(yoffset+screen_row,xoffset+screen_col)),screenmap_peekattr(yoffset+screen_row,xoffset+screen_col));
+
+        canvasactive = 0;
+        VDC_SetDisplay(VDCBASETEXT,VDCBASEATTR,80);
+        viewportrefresh();
+        if(showbar) { initstatusbar(); }
+        VDC_Plot(screen_row,screen_col,plotscreencode,VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
+        gotoxy(screen_col,screen_row);
+    }
+    if(changecanvas) { canvasdirty = 1; }
+}
+
+void scrollviewport(unsigned char direction)
+{
+    // Function to scroll the viewport one position in the given direction
+    // Input: direction as the SCROLL_* direction the screen content moves
+
+    VDC_WaitVBlank();
+    if(canvasactive)
     {
-        VDC_PrintAt(24,62,"BLI",mc_menupopup);
+        if(showbar) { hidestatusbar(); }
     }
     else
     {
-        VDC_PrintAt(24,62,"   ",mc_menupopup);
+        VDC_ScrollCopy(screenmapbase,screenmapbank,screenpitch,SCREENMAP_VIEWATTR,xoffset,yoffset,0,0,80,25,direction);
+    }
+
+    switch (direction)
+    {
+    case SCROLL_LEFT:
+        xoffset++;
+        break;
+
+    case SCROLL_RIGHT:
+        xoffset--;
+        break;
+
+    case SCROLL_DOWN:
+        yoffset--;
+        break;
+
+    case SCROLL_UP:
+        yoffset++;
+        break;
+    
+    default:
+        break;
     }
-    if(plotaltchar)
+
+    if(canvasactive) { canvas_setview(); }
+    if(showbar) { initstatusbar(); }
+}
+
+void scrollviewportsteps(unsigned char direction, unsigned char steps)
+{
+    // Function to scroll the viewport a number of positions in the given direction
+    // One step uses the scroll copy, more steps are drawn with a single viewport refresh
+    // Input: direction as the SCROLL_* direction the screen content moves, number of positions
+
+    if(steps==1) { scrollviewport(direction); return; }
+
+    switch (direction)
     {
-        VDC_PrintAt(24,66,"ALT",mc_menupopup);
+    case SCROLL_LEFT:
+        xoffset += steps;
+        break;
+
+    case SCROLL_RIGHT:
+        xoffset -= steps;
+        break;
+
+    case SCROLL_DOWN:
+        yoffset -= steps;
+        break;
+
+    case SCROLL_UP:
+        yoffset += steps;
+        break;
+    
+    default:
+        break;
+    }
+
+    if(canvasactive)
+    {
+        if(showbar) { hidestatusbar(); }
+        VDC_WaitVBlank();
+        canvas_setview();
     }
     else
     {
-        VDC_PrintAt(24,66,"   ",mc_menupopup);
+        viewportrefresh();
     }
+    if(showbar) { initstatusbar(); }
 }
 
-void initstatusbar()
+void screenmap_rowtable()
 {
-    if(screen_row==24) { return; }
+    // Function to rebuild the row address table for the present screen pitch
+    // Used by the SCREENMAP_SCREENADDR and SCREENMAP_ATTRADDR macros
+
+    unsigned int address = screenmapbase;
+    unsigned int row;
 
-    VDC_FillArea(24,0,CH_SPACE,80,1,mc_menupopup);
-    VDC_PrintAt(24, 0,"Mode:",mc_menupopup);
-    VDC_PrintAt(24,17,"X,Y:",mc_menupopup);
-    VDC_PrintAt(24,31,"Char:",mc_menupopup);
-    VDC_PrintAt(24,41,"Color:",mc_menupopup);
-    VDC_PrintAt(24,73,"F8=Help",mc_menupopup);
-    printstatusbar();
+    for(row=0;row<screenheight && row<SCREENMAPMAXROWS;row++)
+    {
+        screenmap_rowaddress[row] = address;
+        address += screenpitch;
+    }
 }
 
-void hidestatusbar()
+unsigned char screenmap_peek(unsigned int address)
 {
-    VDC_CopyViewPortToVDC(SCREENMAPBASE,1,screenwidth,screenheight,xoffset,yoffset+24,0,24,80,1);
+    // Function to read a byte of the screen map, in bank 1 or in VDC memory
+
+    return (screenmapbank == VDC_BANKVDC)? VDC_Peek(address) : PEEKB(address,1);
 }
 
-void togglestatusbar()
+void screenmap_poke(unsigned int address, unsigned char value)
 {
-    if(screen_row==24) { return; }
+    // Function to write a byte of the screen map, in bank 1 or in VDC memory
 
-    if(showbar)
+    if(screenmapbank == VDC_BANKVDC) { VDC_Poke(address,value); } else { POKEB(address,1,value); }
+}
+
+unsigned char screenmap_peekattr(unsigned int row, unsigned int col)
+{
+    // Function to read the attribute of a cell, the canvas attribute for a monochrome map
+
+    return (monochrome)? VDC_fillattribute : screenmap_peek(SCREENMAP_ATTRADDR(row,col));
+}
+
+void screenmap_pokeattr(unsigned int row, unsigned int col, unsigned char attribute)
+{
+    // Function to write the attribute of a cell, ignored for a monochrome map
+
+    if(!monochrome) { screenmap_poke(SCREENMAP_ATTRADDR(row,col),attribute); }
+}
+
+unsigned char screenmap_storage(unsigned int width, unsigned int height)
+{
+    // Function to determine where a packed screen map of the given size can be stored
+    // Bank 1 is preferred, VDC memory is used for larger canvases on 64KB VDC
+    // Output: 1 for bank 1, VDC_BANKVDC for VDC memory, 0 if the size is not supported
+
+    unsigned long size = ((unsigned long)width * height * SCREENMAP_PLANES) + 48;
+
+    if(height > SCREENMAPMAXROWS) { return 0; }
+    if(size <= MEMORYLIMIT - SCREENMAPBASE) { return 1; }
+    if(vdcmemory == 64 && size <= SCREENMAPVDCLIMIT) { return VDC_BANKVDC; }
+    return 0;
+}
+
+void screenmap_setstorage(unsigned char bank)
+{
+    // Function to move a packed screen map between bank 1 and VDC memory
+    // In VDC memory the map takes the first allocated region and may grow into the undo region,
+    // so canvas_configure has to be called after the map has its final size
+    // Input: bank 1 or VDC_BANKVDC
+
+    unsigned int base = SCREENMAPBASE;
+
+    if(!bank || bank == screenmapbank) { return; }
+
+    VDC_MemReset();
+    canvasbase = 0;
+    if(bank == VDC_BANKVDC)
     {
-        showbar=0;
-        hidestatusbar();
+        base = VDC_MemAllocRest("Map");
+        VDC_CopyMemToVDC(base,screenmapbase,1,SCREENMAP_SIZE);
     }
     else
     {
-        showbar=1;
-        initstatusbar();
+        VDC_CopyVDCToMem(screenmapbase,base,1,SCREENMAP_SIZE);
     }
+    screenmapbank = bank;
+    screenmapbase = base;
+    screenmap_rowtable();
 }
 
-unsigned int screenmap_screenaddr(unsigned char row, unsigned char col, unsigned int width)
+void screenmap_setpacked()
 {
-    return SCREENMAPBASE+(row*width)+col;
+    // Function to set the layout variables for a packed screen map as in the screen file format
+
+    screenpitch = screenwidth;
+    screentotal = screenwidth*screenheight;
+    screenmap_attroffset = screentotal + 48;
+    screenmap_rowtable();
 }
 
-unsigned int screenmap_attraddr(unsigned char row, unsigned char col, unsigned int width, unsigned int height)
+void screenmap_settables()
 {
-    // Function to calculate screenmap address for the attribute space
-    // Input: row, col, width and height for screenmap
-    return SCREENMAPBASE+(row*width)+col+(width*height)+48;
+    // Function to set layout variables after loading or sizing a packed screen map
+    // Converts to page aligned layout if selected
+
+    screenmap_setpacked();
+    screenmap_setlayout(mapalign);
 }
 
-void screenmapplot(unsigned char row, unsigned char col, unsigned char screencode, unsigned char attribute)
+unsigned char screenmap_setlayout(unsigned char aligned)
 {
-    // Function to plot a screencodes at bank 1 memory screen map
+    // Function to convert the screen map between packed layout and page aligned layout
+    // Page aligned pads every row of both planes to 256 bytes and the gap to a full page,
+    // if the width is 256 or less and there is enough memory. Otherwise packed layout is used.
+    // The layout menu option shows the layout actually used
+    // Input: aligned = 1 for page aligned layout, 0 for packed layout as in the screen file format
+    // Output: 1 if page aligned layout is used, 0 for packed layout
+
+    unsigned int newpitch = screenwidth;
+    unsigned int newattroffset = screentotal + 48;
+    unsigned char applied = 0;
+
+    if(aligned && screenmapbank == 1 && screenwidth <= 256 && screenheight <= (MEMORYLIMIT-SCREENMAPBASE-256)/512)
+    {
+        newpitch = 256;
+        newattroffset = (screenheight<<8) + 256;
+        applied = 1;
+    }
+    sprintf(pulldownmenutitles[3][2],"Map: %s",(applied)? "Aligned   ":"Packed    ");
+    if(newpitch == screenpitch && newattroffset == screenmap_attroffset) { return applied; }
+
+    // Move planes, attribute plane first if it moves up, a monochrome map has no attribute plane
+    if(!monochrome && newattroffset > screenmap_attroffset) { BankRectCopy(screenmapbase+screenmap_attroffset,screenpitch,screenmapbase+newattroffset,newpitch,screenmapbank,screenwidth,screenheight); }
+    BankRectCopy(screenmapbase,screenpitch,screenmapbase,newpitch,screenmapbank,screenwidth,screenheight);
+    if(!monochrome && newattroffset <= screenmap_attroffset) { BankRectCopy(screenmapbase+screenmap_attroffset,screenpitch,screenmapbase+newattroffset,newpitch,screenmapbank,screenwidth,screenheight); }
+
+    // Set new layout and restore gap between planes
+    screenpitch = newpitch;
+    screenmap_attroffset = newattroffset;
+    screenmap_rowtable();
+    BankMemSet(screenmapbase+(screenpitch*screenheight),screenmapbank,CH_SPACE,screenmap_attroffset-(screenpitch*screenheight));
+    placesignature();
+    return applied;
+}
+
+void screenmapplot(unsigned int row, unsigned int col, unsigned char screencode, unsigned char attribute)
+{
+    // Function to plot a screencodes at the screen map
 	// Input: row and column, screencode to plot, attribute code
 
-    POKEB(screenmap_screenaddr(row,col,screenwidth),1,screencode);
-    POKEB(screenmap_attraddr(row,col,screenwidth,screenheight),1,attribute);
+    screenmap_poke(SCREENMAP_SCREENADDR(row,col),screencode);
+    screenmap_pokeattr(row,col,attribute);
+
+    // Write through to canvas copy in VDC memory
+    if(canvasactive)
+    {
+        VDC_Poke(canvasbase-screenmapbase+SCREENMAP_SCREENADDR(row,col),screencode);
+        if(!monochrome) { VDC_Poke(canvasbase-screenmapbase+SCREENMAP_ATTRADDR(row,col),attribute); }
+    }
 }
 
 void placesignature()
@@ -828,26 +1304,140 @@ void placesignature()
 
     char versiontext[49] = "";
     unsigned char x;
-    unsigned int address = SCREENMAPBASE + (screenwidth*screenheight);
+    unsigned int address = screenmapbase + screenmap_attroffset - 48;
 
     sprintf(versiontext,"VDC Screen Editor %s X.Mol ",version);
 
     for(x=0;x<strlen(versiontext);x++)
     {
-        POKEB(address+x,1,versiontext[x]);
+        screenmap_poke(address+x,versiontext[x]);
+    }
+}
+
+void screenmap_resize(unsigned int newwidth, unsigned int newheight, unsigned char anchor)
+{
+    // Function to resize the screen map in place
+    // Resizes in packed layout, then converts to page aligned layout again if selected
+    // A map growing beyond bank 1 is moved to VDC memory first, a map shrinking to fit bank 1 is moved back after
+    // Input: new width and height, anchor flags for the edges the content stays attached to
+
+    unsigned char bank = screenmap_storage(newwidth,newheight);
+
+    screenmap_setlayout(0);
+    if(bank == VDC_BANKVDC) { screenmap_setstorage(bank); }
+    screenmap_resizepacked(newwidth,newheight,anchor);
+    screenmap_setstorage(bank);
+    screenmap_setlayout(mapalign);
+}
+
+unsigned char screenmap_setmonochrome(unsigned char mono)
+{
+    // Function to convert the screen map between colour and monochrome
+    // To monochrome the attribute plane is dropped and the present plot attribute is used for all cells,
+    // to colour an attribute plane filled with the monochrome canvas attribute is added
+    // Input: mono = 1 for monochrome, 0 for colour. Output: 1 if converted, 0 if the map does not fit
+
+    unsigned char bank;
+
+    if(mono == monochrome) { return 1; }
+
+    // Determine storage for the size with the new number of planes
+    monochrome = mono;
+    bank = screenmap_storage(screenwidth,screenheight);
+    monochrome = !mono;
+    if(!bank) { return 0; }
+
+    screenmap_setlayout(0);
+    if(mono)
+    {
+        VDC_fillattribute = VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar);
+        monochrome = 1;
+        screenmap_setstorage(bank);
+    }
+    else
+    {
+        if(bank == VDC_BANKVDC) { screenmap_setstorage(bank); }
+        monochrome = 0;
+        BankMemSet(screenmapbase+screenmap_attroffset,screenmapbank,VDC_fillattribute,screentotal);
     }
+    screenmap_setlayout(mapalign);
+    canvas_configure();
+    dirty_markall();
+    return 1;
+}
+
+void screenmap_resizepacked(unsigned int newwidth, unsigned int newheight, unsigned char anchor)
+{
+    // Function to resize a packed screen map in place, one overlap safe pass per plane
+    // Input: new width and height, anchor flags for the edges the content stays attached to
+    // The plane that grows into the other one is moved first. Width and height changes in
+    // opposite directions are done as two passes, as a single pass could overwrite unread rows.
+
+    unsigned int copywidth, copyheight;
+    unsigned int srccol = 0, srcrow = 0, destcol = 0, destrow = 0;
+    unsigned int oldattr, newattr, fill;
+    unsigned char attrfirst;
+
+    if(newwidth != screenwidth && newheight != screenheight && (newwidth > screenwidth) != (newheight > screenheight))
+    {
+        screenmap_resizepacked(newwidth,screenheight,anchor);
+    }
+
+    // Determine copied area and its position in old and new map
+    copywidth = (newwidth < screenwidth)? newwidth : screenwidth;
+    copyheight = (newheight < screenheight)? newheight : screenheight;
+    if(anchor & RESIZE_ANCHORRIGHT)
+    {
+        if(newwidth < screenwidth) { srccol = screenwidth - newwidth; } else { destcol = newwidth - screenwidth; }
+    }
+    if(anchor & RESIZE_ANCHORBOTTOM)
+    {
+        if(newheight < screenheight) { srcrow = screenheight - newheight; } else { destrow = newheight - screenheight; }
+    }
+    oldattr = screenmapbase + (screenwidth*screenheight) + 48 + (srcrow*screenwidth) + srccol;
+    newattr = screenmapbase + (newwidth*newheight) + 48 + (destrow*newwidth) + destcol;
+    attrfirst = (newwidth*newheight > screenwidth*screenheight);
+
+    // Move planes, a monochrome map only has the screencode plane
+    if(!monochrome && attrfirst) { BankRectCopy(oldattr,screenwidth,newattr,newwidth,screenmapbank,copywidth,copyheight); }
+    BankRectCopy(screenmapbase+(srcrow*screenwidth)+srccol,screenwidth,screenmapbase+(destrow*newwidth)+destcol,newwidth,screenmapbank,copywidth,copyheight);
+    if(!monochrome && !attrfirst) { BankRectCopy(oldattr,screenwidth,newattr,newwidth,screenmapbank,copywidth,copyheight); }
+
+    // Clear added columns and rows
+    newattr = screenmapbase + (newwidth*newheight) + 48;
+    if(newwidth > screenwidth)
+    {
+        fill = (anchor & RESIZE_ANCHORRIGHT)? 0 : screenwidth;
+        BankRectSet(screenmapbase+fill,newwidth,screenmapbank,CH_SPACE,newwidth-screenwidth,newheight);
+        if(!monochrome) { BankRectSet(newattr+fill,newwidth,screenmapbank,VDC_WHITE,newwidth-screenwidth,newheight); }
+    }
+    if(newheight > screenheight)
+    {
+        fill = (anchor & RESIZE_ANCHORBOTTOM)? 0 : screenheight*newwidth;
+        BankMemSet(screenmapbase+fill,screenmapbank,CH_SPACE,(newheight-screenheight)*newwidth);
+        if(!monochrome) { BankMemSet(newattr+fill,screenmapbank,VDC_WHITE,(newheight-screenheight)*newwidth); }
+    }
+
+    // Set new size and restore gap between planes
+    screenwidth = newwidth;
+    screenheight = newheight;
+    screenmap_setpacked();
+    BankMemSet(screenmapbase+screentotal,screenmapbank,CH_SPACE,48);
+    placesignature();
 }
 
 void screenmapfill(unsigned char screencode, unsigned char attribute)
 {
     // Function to fill screen with the screencode and attribute code provided as input
 
-    unsigned int address = SCREENMAPBASE;
+    unsigned int address = screenmapbase;
     
-    BankMemSet(address,1,screencode,screentotal+48);
+    BankMemSet(address,screenmapbank,screencode,screenmap_attroffset);
     placesignature();
-    address += screentotal + 48;
-    BankMemSet(address,1,attribute,screentotal);
+    address += screenmap_attroffset;
+    if(monochrome) { VDC_fillattribute = attribute; }     // Canvas attribute of a monochrome map
+    else { BankMemSet(address,screenmapbank,attribute,screenpitch*screenheight); }
+    dirty_markall();
 }
 
 void cursormove(unsigned char left, unsigned char right, unsigned char up, unsigned char down)
@@ -862,8 +1452,7 @@ void cursormove(unsigned char left, unsigned char right, unsigned char up, unsig
             if(xoffset>0)
             {
                 gotoxy(screen_col,screen_row);
-                VDC_ScrollCopy(SCREENMAPBASE,1,screenwidth,screenheight,xoffset--,yoffset,0,0,80,25,2);
-                initstatusbar();
+                scrollviewport(SCROLL_RIGHT);
             }
         }
         else
@@ -878,8 +1467,7 @@ void cursormove(unsigned char left, unsigned char right, unsigned char up, unsig
             if(xoffset+screen_col<screenwidth-1)
             {
                 gotoxy(screen_col,screen_row);
-                VDC_ScrollCopy(SCREENMAPBASE,1,screenwidth,screenheight,xoffset++,yoffset,0,0,80,25,1);
-                initstatusbar();
+                scrollviewport(SCROLL_LEFT);
             }
         }
         else
@@ -894,8 +1482,7 @@ void cursormove(unsigned char left, unsigned char right, unsigned char up, unsig
             if(yoffset>0)
             {
                 gotoxy(screen_col,screen_row);
-                VDC_ScrollCopy(SCREENMAPBASE,1,screenwidth,screenheight,xoffset,yoffset--,0,0,80,25,4);
-                initstatusbar();
+                scrollviewport(SCROLL_DOWN);
             }
         }
         else
@@ -912,8 +1499,7 @@ void cursormove(unsigned char left, unsigned char right, unsigned char up, unsig
             if(yoffset+screen_row<screenheight-1)
             {
                 gotoxy(screen_col,screen_row);
-                VDC_ScrollCopy(SCREENMAPBASE,1,screenwidth,screenheight,xoffset,yoffset++,0,0,80,25,8);
-                initstatusbar();
+                scrollviewport(SCROLL_UP);
             }
         }
         else
@@ -921,128 +1507,505 @@ void cursormove(unsigned char left, unsigned char right, unsigned char up, unsig
             gotoxy(screen_col,++screen_row);
         }
     }
+    if(canvasactive) { VDC_CursorAt(screen_row,screen_col); }
+}
+
+unsigned char cursorkeycount(unsigned char key)
+{
+    // Function to count and remove repeats of a cursor key waiting in the kernal keyboard buffer
+    // Only repeats directly following the key already read are taken, other keys stay pending
+    // Input: key already read. Output: number of steps to move including that key
+
+    unsigned char count = 0;
+    unsigned char pending, x;
+
+    __asm__("sei");
+    pending = PEEK(KEYBUFFERCOUNT);
+    while(count<pending && PEEK(KEYBUFFER+count)==key) { count++; }
+    if(count)
+    {
+        for(x=count;x<pending;x++) { POKE(KEYBUFFER+x-count,PEEK(KEYBUFFER+x)); }
+        POKE(KEYBUFFERCOUNT,pending-count);
+    }
+    __asm__("cli");
+    return count+1;
+}
+
+void cursormovesteps(unsigned char direction, unsigned char steps)
+{
+    // Move cursor a number of steps in one direction
+    // The cursor first moves within the screen, the rest is done by one scroll of the viewport
+    // Input: ASCII code of cursor key pressed and number of steps
+
+    unsigned char move = 0;
+    unsigned char scroll = 0;
+    unsigned char scrolldirection = 0;
+    unsigned int room;
+
+    switch (direction)
+    {
+    case CH_CURS_LEFT:
+        move = (steps>screen_col)? screen_col : steps;
+        screen_col -= move;
+        scroll = (steps-move>xoffset)? xoffset : steps-move;
+        scrolldirection = SCROLL_RIGHT;
+        break;
+    
+    case CH_CURS_RIGHT:
+        move = (steps>79-screen_col)? 79-screen_col : steps;
+        screen_col += move;
+        room = screenwidth-80-xoffset;
+        scroll = (steps-move>room)? room : steps-move;
+        scrolldirection = SCROLL_LEFT;
+        break;
+
+    case CH_CURS_UP:
+        move = (steps>screen_row)? screen_row : steps;
+        screen_row -= move;
+        scroll = (steps-move>yoffset)? yoffset : steps-move;
+        scrolldirection = SCROLL_DOWN;
+        if(showbar && move && !scroll && screen_row+move==24) { initstatusbar(); }
+        break;
+
+    case CH_CURS_DOWN:
+        move = (steps>24-screen_row)? 24-screen_row : steps;
+        if(move && screen_row+move==24) { hidestatusbar(); }
+        screen_row += move;
+        room = screenheight-25-yoffset;
+        scroll = (steps-move>room)? room : steps-move;
+        scrolldirection = SCROLL_UP;
+        break;
+    
+    default:
+        break;
+    }
+
+    gotoxy(screen_col,screen_row);
+    if(scroll) { scrollviewportsteps(scrolldirection,scroll); }
+    if(canvasactive) { VDC_CursorAt(screen_row,screen_col); }
 }
 
 // Functions for undo system
+// Undo steps are kept as a journal of variable length records in VDC memory or REU, indexed by start address.
+// A record holds a header with the rectangle and the XOR difference of its contents before and after the change,
+// run length encoded per chunk of a row. Applying the same record to the screen map undoes or redoes the change.
+// On undo_new the contents before the change are copied raw behind the place of the record, the record is
+// encoded on the next undo action, when the change is complete.
 
-void undo_new(unsigned char row, unsigned char col, unsigned char width, unsigned char height)
+void undo_journalcopy(unsigned char command, unsigned int undoaddr, unsigned int address, unsigned char bank, unsigned int length)
 {
-    // Function to create a new undo buffer position
+    // Function to copy between the undo journal in VDC memory or REU and memory
+    // Input: REU_STASH to copy to the journal or REU_FETCH to copy from the journal, journal address,
+    //        memory address and bank (or VDC_BANKVDC for a screen map in VDC memory), number of bytes
 
-    unsigned char y;
-    unsigned char redoroompresent = 1;
+    if(undoinreu) { REU_Transfer(command,address,bank,undoaddr,REUBANK_UNDO,length); }
+    else if(command == REU_STASH) { VDC_CopyMemToVDC(undoaddr,address,bank,length); }
+    else { VDC_CopyVDCToMem(undoaddr,address,bank,length); }
+}
 
-    if(undo_redopossible>0)
+void undo_mapcopy(unsigned char write, unsigned int mapaddr, unsigned char* buffer, unsigned char length)
+{
+    // Function to read (write = 0) or write (write = 1) part of a screen map row via a buffer in bank 0
+
+    if(screenmapbank == VDC_BANKVDC)
     {
-        undo_undopossible=1;        
-        undo_redopossible=0;
+        if(write) { VDC_CopyMemToVDC(mapaddr,(unsigned int)buffer,0,length); }
+        else { VDC_CopyVDCToMem(mapaddr,(unsigned int)buffer,0,length); }
     }
     else
     {
-        undo_undopossible++;
+        if(write) { BankMemCopy((unsigned int)buffer,0,mapaddr,1,length); }
+        else { BankMemCopy(mapaddr,1,(unsigned int)buffer,0,length); }
     }
-    undonumber++;
-    if(undonumber>40) { undonumber=1;}
-    if(undoaddress+(width*height*4)<undoaddress) { undonumber = 1; undoaddress = VDCEXTENDED; }
-    if(undoaddress+(width*height*4)>(0xffff - VDCEXTENDED)) { redoroompresent = 0; }
-    for(y=0;y<height;y++)
+}
+
+void undo_putbyte(unsigned char value)
+{
+    // Function to write a byte to the journal via the stream buffer
+
+    undo_stream[undo_streamfill++] = value;
+    if(undo_streamfill == UNDOCHUNK) { undo_flush(); }
+}
+
+void undo_flush()
+{
+    // Function to write the bytes in the stream buffer to the journal
+
+    if(!undo_streamfill) { return; }
+    undo_journalcopy(REU_STASH,undo_streamaddress,(unsigned int)undo_stream,0,undo_streamfill);
+    undo_streamaddress += undo_streamfill;
+    undo_streamfill = 0;
+}
+
+unsigned char undo_getbyte()
+{
+    // Function to read a byte from the journal via the stream buffer
+
+    if(undo_streampos == undo_streamfill)
     {
-        VDC_CopyMemToVDC(undoaddress+(y*width),screenmap_screenaddr(row+y,col,screenwidth),1,width);
-        VDC_CopyMemToVDC(undoaddress+(width*height)+(y*width),screenmap_attraddr(row+y,col,screenwidth,screenheight),1,width);
+        undo_journalcopy(REU_FETCH,undo_streamaddress,(unsigned int)undo_stream,0,UNDOCHUNK);
+        undo_streamaddress += UNDOCHUNK;
+        undo_streamfill = UNDOCHUNK;
+        undo_streampos = 0;
     }
-    Undo[undonumber-1].address = undoaddress;
-    if(undonumber<40) { Undo[undonumber].address = 0; } else { Undo[0].address = 0; }
-    Undo[undonumber-1].xstart = col;
-    Undo[undonumber-1].ystart = row;
-    Undo[undonumber-1].width = width;
-    Undo[undonumber-1].height = height;
-    Undo[undonumber-1].redopresent = redoroompresent;
-    undoaddress += width*height*(2+(2*redoroompresent));
-    //gotoxy(0,24);
-    //cprintf("UN: %u UA: %4X RF: %u NA: %4X UP: %u RP: %u    ",undonumber,Undo[undonumber-1].address,Undo[undonumber-1].redopresent,undoaddress,undo_undopossible,undo_redopossible);   
+    return undo_stream[undo_streampos++];
 }
 
-void undo_performundo()
+void undo_encode(unsigned char length)
 {
-    // Function to perform an undo if a filled undo slot is present
+    // Function to run length encode a chunk of XOR differences in undo_buffer to the journal
+    // Control byte 0-127: 1-128 literal bytes follow, 128-255: next byte repeated 3-130 times
+    // Output size is at most length+1 bytes
 
-    unsigned char y, row, col, width, height;
+    unsigned char x = 0;
+    unsigned char start, run, value;
 
-    if(undo_undopossible>0)
+    while(x < length)
+    {
+        value = undo_buffer[x];
+        if(value) { undo_changed = 1; }
+        run = 1;
+        while(x+run < length && undo_buffer[x+run] == value && run < 130) { run++; }
+        if(run >= 3)
+        {
+            undo_putbyte(0x80 | (run-3));
+            undo_putbyte(value);
+            x += run;
+            continue;
+        }
+
+        // Literal bytes up to the next run of three equal bytes
+        start = x;
+        do
+        {
+            if(undo_buffer[x]) { undo_changed = 1; }
+            x++;
+        } while(x < length && x-start < 128 && !(x+2 < length && undo_buffer[x] == undo_buffer[x+1] && undo_buffer[x] == undo_buffer[x+2]));
+        undo_putbyte(x-start-1);
+        for(run=start;run<x;run++) { undo_putbyte(undo_buffer[run]); }
+    }
+}
+
+unsigned char undo_decode(unsigned char length)
+{
+    // Function to decode a chunk of XOR differences from the journal to undo_delta
+    // Output: 1 if any difference is not zero
+
+    unsigned char x = 0;
+    unsigned char control, count, value;
+    unsigned char changed = 0;
+
+    while(x < length)
+    {
+        control = undo_getbyte();
+        if(control & 0x80)
+        {
+            count = (control & 0x7f) + 3;
+            value = undo_getbyte();
+            if(value) { changed = 1; }
+            memset(undo_delta+x,value,count);
+            x += count;
+        }
+        else
+        {
+            count = control + 1;
+            while(count--)
+            {
+                if((undo_delta[x++] = undo_getbyte())) { changed = 1; }
+            }
+        }
+    }
+    return changed;
+}
+
+unsigned int undo_mapaddress(unsigned char plane, unsigned int row, unsigned int col)
+{
+    // Function to get the screen map address of a cell in the screencode (0) or attribute plane (1)
+
+    return (plane)? SCREENMAP_ATTRADDR(row,col) : SCREENMAP_SCREENADDR(row,col);
+}
+
+void undo_setflags()
+{
+    // Function to set the number of possible undo and redo steps
+
+    undo_undopossible = undo_position + (undo_pending || undo_transaction);
+    undo_redopossible = undo_count - undo_position;
+}
+
+void undo_reset(unsigned int start, unsigned int end)
+{
+    // Function to empty the undo journal
+    // Input: start address and end address (exclusive) of journal memory, an end of 0 stands for
+    //        the end of the 64K address space. Start equal to end gives a journal without memory.
+    //        Sizes are only used as end minus start, which wraps correctly for an end of 0
+
+    undostart = start;
+    undoend = end;
+    undo_tail = start;
+    undo_first = 0;
+    undo_count = 0;
+    undo_position = 0;
+    undo_pending = 0;
+    undo_transaction = 0;
+    undo_setflags();
+}
+
+void undo_dropoldest()
+{
+    // Function to drop the oldest record of the journal
+
+    undo_first = (undo_first+1) & (UNDOSLOTS-1);
+    undo_count--;
+    if(undo_position) { undo_position--; }
+}
+
+unsigned char undo_alloc(unsigned int row, unsigned int col, unsigned int width, unsigned int height)
+{
+    // Function to make room in the journal for a new undo record and set its header
+    // Closes the previous record and drops steps that could be redone
+    // Output: 1 if room is made, 0 if the record does not fit in the journal
+
+    unsigned int plane, slack;
+    unsigned long need;
+    unsigned char planes = SCREENMAP_PLANES;
+
+    undo_close();
+    if(undo_position < undo_count)
+    {
+        undo_tail = undo_index[(undo_first+undo_position) & (UNDOSLOTS-1)];
+        undo_count = undo_position;
+    }
+    if(undo_count == UNDOSLOTS) { undo_dropoldest(); }
+
+    // Room for header, worst case encoded size and the raw contents before the change
+    plane = width*height;
+    slack = height * planes * ((width+UNDOCHUNK-1)/UNDOCHUNK);
+    need = (unsigned long)plane * planes + UNDOHEADER + slack;
+    if(need > undoend - undostart) { undo_reset(undostart,undoend); return 0; }
+
+    // Wrap to start of journal memory, dropping the records behind the tail first as these are the oldest
+    if(need > undoend - undo_tail)
+    {
+        while(undo_count && undo_index[undo_first] >= undo_tail) { undo_dropoldest(); }
+        undo_tail = undostart;
+    }
+    while(undo_count && undo_index[undo_first] >= undo_tail && undo_index[undo_first] - undo_tail < need) { undo_dropoldest(); }
+
+    undo_header[0] = row;
+    undo_header[1] = col;
+    undo_header[2] = width;
+    undo_header[3] = height;
+    undo_raw = undo_tail + UNDOHEADER + slack;
+    return 1;
+}
+
+void undo_new(unsigned int row, unsigned int col, unsigned int width, unsigned int height)
+{
+    // Function to start a new undo record for a rectangle of the screen map that is about to change
+
+    unsigned int y;
+    unsigned char p;
+    unsigned char planes = SCREENMAP_PLANES;
+
+    if(!undoenabled || !undo_alloc(row,col,width,height)) { return; }
+
+    // Copy raw contents before the change
+    for(p=0;p<planes;p++)
     {
-        row = Undo[undonumber-1].ystart;
-        col = Undo[undonumber-1].xstart;
-        width = Undo[undonumber-1].width;
-        height = Undo[undonumber-1].height;
         for(y=0;y<height;y++)
         {
-            if(Undo[undonumber-1].redopresent>0)
+            undo_journalcopy(REU_STASH,undo_raw+(p*width*height)+(y*width),undo_mapaddress(p,row+y,col),screenmapbank,width);
+        }
+    }
+    undo_pending = 1;
+    undo_setflags();
+}
+
+void undo_close()
+{
+    // Function to encode the pending undo record as difference between the raw copy and the present screen map
+    // A running transaction is first written to the journal as a record of the cells it touched
+    // Records without differences are dropped
+
+    unsigned int y, x, raw;
+    unsigned char p, length, i;
+    unsigned char planes = SCREENMAP_PLANES;
+
+    if(undo_transaction)
+    {
+        undo_transaction = 0;
+        if(undo_alloc(undo_txrow,undo_txcol,undo_txwidth,1))
+        {
+            undo_journalcopy(REU_STASH,undo_raw,(unsigned int)undo_buffer,0,undo_txwidth);
+            if(planes == 2) { undo_journalcopy(REU_STASH,undo_raw+undo_txwidth,(unsigned int)undo_delta,0,undo_txwidth); }
+            undo_pending = 1;
+        }
+    }
+    if(!undo_pending) { return; }
+    undo_pending = 0;
+
+    undo_changed = 0;
+    undo_streamaddress = undo_tail + UNDOHEADER;
+    undo_streamfill = 0;
+    for(p=0;p<planes;p++)
+    {
+        for(y=0;y<undo_header[3];y++)
+        {
+            raw = undo_raw + (p*undo_header[2]*undo_header[3]) + (y*undo_header[2]);
+            for(x=0;x<undo_header[2];x+=length)
             {
-                VDC_CopyMemToVDC(Undo[undonumber-1].address+(width*height*2)+(y*width),screenmap_screenaddr(row+y,col,screenwidth),1,width);
-                VDC_CopyMemToVDC(Undo[undonumber-1].address+(width*height*3)+(y*width),screenmap_attraddr(row+y,col,screenwidth,screenheight),1,width);
+                length = (undo_header[2]-x > UNDOCHUNK)? UNDOCHUNK : undo_header[2]-x;
+                undo_journalcopy(REU_FETCH,raw,(unsigned int)undo_buffer,0,length);
+                raw += length;
+                undo_mapcopy(0,undo_mapaddress(p,undo_header[0]+y,undo_header[1]+x),undo_delta,length);
+                for(i=0;i<length;i++) { undo_buffer[i] ^= undo_delta[i]; }
+                undo_encode(length);
             }
-            VDC_CopyVDCToMem(Undo[undonumber-1].address+(y*width),screenmap_screenaddr(row+y,col,screenwidth),1,width);
-            VDC_CopyVDCToMem(Undo[undonumber-1].address+(width*height)+(y*width),screenmap_attraddr(row+y,col,screenwidth,screenheight),1,width);
         }
-        VDC_CopyViewPortToVDC(SCREENMAPBASE,1,screenwidth,screenheight,xoffset,yoffset,0,0,80,25);
-        if(showbar) { initstatusbar(); }
-        if(Undo[undonumber-1].redopresent>0) { Undo[undonumber-1].redopresent=2; undo_redopossible++; }
-        //gotoxy(0,24);
-        //cprintf("UN: %u UA: %4X RF: %u ",undonumber,Undo[undonumber-1].address,Undo[undonumber-1].redopresent); 
-        undoaddress = Undo[undonumber-1].address;   
-        undonumber--;
-        if(undonumber==0)
+    }
+    undo_flush();
+
+    if(undo_changed)
+    {
+        undo_journalcopy(REU_STASH,undo_tail,(unsigned int)undo_header,0,UNDOHEADER);
+        undo_index[(undo_first+undo_count) & (UNDOSLOTS-1)] = undo_tail;
+        undo_tail = undo_streamaddress;
+        undo_count++;
+        undo_position = undo_count;
+    }
+    undo_setflags();
+}
+
+void undo_apply(unsigned char slot)
+{
+    // Function to apply the XOR differences of an undo record to the screen map, undoing or redoing its change
+    // Only chunks with differences are read and written back
+
+    unsigned int y, x;
+    unsigned char p, length, i;
+    unsigned char planes = SCREENMAP_PLANES;
+    unsigned int address = undo_index[(undo_first+slot) & (UNDOSLOTS-1)];
+
+    undo_journalcopy(REU_FETCH,address,(unsigned int)undo_header,0,UNDOHEADER);
+    undo_streamaddress = address + UNDOHEADER;
+    undo_streamfill = 0;
+    undo_streampos = 0;
+    for(p=0;p<planes;p++)
+    {
+        for(y=0;y<undo_header[3];y++)
         {
-            if(Undo[39].address>0) { undonumber=40; }
-        }    
-        undo_undopossible--;
-        if(undonumber>0 && Undo[undonumber-1].address==0) { undo_undopossible=0; }
-        if(undonumber==0 && Undo[39].address==0) { undo_undopossible=0; }
-        //cprintf("NN: %u NA: %4X UP: %u RP: %u    ",undonumber,undoaddress,undo_undopossible,undo_redopossible); 
+            for(x=0;x<undo_header[2];x+=length)
+            {
+                length = (undo_header[2]-x > UNDOCHUNK)? UNDOCHUNK : undo_header[2]-x;
+                if(undo_decode(length))
+                {
+                    address = undo_mapaddress(p,undo_header[0]+y,undo_header[1]+x);
+                    undo_mapcopy(0,address,undo_buffer,length);
+                    for(i=0;i<length;i++) { undo_buffer[i] ^= undo_delta[i]; }
+                    undo_mapcopy(1,address,undo_buffer,length);
+                }
+            }
+        }
     }
+    undo_streamfill = 0;
+    dirty_mark(undo_header[0],undo_header[1],undo_header[2],undo_header[3]);
+    if(dirty_refresh() && showbar) { initstatusbar(); }
 }
 
-void undo_escapeundo()
+void undo_performundo()
 {
-    // Function to cancel an undo slot after escape is pressed in selectmode or movemode
+    // Function to perform an undo if a filled undo slot is present
 
-    Undo[undonumber].address = 0;
-    undonumber--;
-    if(undonumber==0)
+    undo_close();
+    if(undo_position)
     {
-        if(Undo[39].address>0) { undonumber=40; }
-    }  
+        undo_apply(--undo_position);
+    }
+    undo_setflags();
 }
 
-void undo_performredo()
+void undo_txcapture(unsigned char x)
 {
-    // Function to perform an redo if a filled redo slot is present
+    // Function to copy the cell at column undo_txcol+x of the transaction row to the before buffers
 
-    unsigned char y, row, col, width, height;
+    undo_buffer[x] = screenmap_peek(undo_mapaddress(0,undo_txrow,undo_txcol+x));
+    if(!monochrome) { undo_delta[x] = screenmap_peek(undo_mapaddress(1,undo_txrow,undo_txcol+x)); }
+}
+
+void undo_begin(unsigned int row, unsigned int col)
+{
+    // Function to add a keystroke edit of a cell to the running undo transaction
+    // A transaction keeps the contents before the change of the cells it touched in RAM, using the encode
+    // buffers as these are only used after the transaction is closed. Edits next to the touched cells on the
+    // same row grow the span, another row, a gap, an idle pause or a full span write the record and start a new one.
+
+    unsigned int now = PEEK(JIFFYCLOCK+2) | (PEEK(JIFFYCLOCK+1)<<8);
+    unsigned char grow = 0;
 
-    if(undo_redopossible>0)
+    if(!undoenabled) { return; }
+
+    if(undo_transaction && undo_txrow == row && now - undo_lastedit < UNDOIDLE)
     {
-        if(undonumber<39) { undonumber++; } else { undonumber = 1; }
-        row = Undo[undonumber-1].ystart;
-        col = Undo[undonumber-1].xstart;
-        width = Undo[undonumber-1].width;
-        height = Undo[undonumber-1].height;
-        for(y=0;y<height;y++)
+        if(col >= undo_txcol && col < undo_txcol+undo_txwidth) { grow = 1; }
+        else if(undo_txwidth < UNDOCHUNK)
         {
-            VDC_CopyVDCToMem(Undo[undonumber-1].address+(width*height*2)+(y*width),screenmap_screenaddr(row+y,col,screenwidth),1,width);
-            VDC_CopyVDCToMem(Undo[undonumber-1].address+(width*height*3)+(y*width),screenmap_attraddr(row+y,col,screenwidth,screenheight),1,width);
+            if(col+1 == undo_txcol)
+            {
+                memmove(undo_buffer+1,undo_buffer,undo_txwidth);
+                memmove(undo_delta+1,undo_delta,undo_txwidth);
+                undo_txcol--;
+                undo_txwidth++;
+                undo_txcapture(0);
+                grow = 1;
+            }
+            else if(col == undo_txcol+undo_txwidth)
+            {
+                undo_txwidth++;
+                undo_txcapture(undo_txwidth-1);
+                grow = 1;
+            }
         }
-        VDC_CopyViewPortToVDC(SCREENMAPBASE,1,screenwidth,screenheight,xoffset,yoffset,0,0,80,25);
-        if(showbar) { initstatusbar(); }
-        //gotoxy(0,24);
-        //cprintf("UN: %u UA: %4X RF: %u ",undonumber,Undo[undonumber-1].address,Undo[undonumber-1].redopresent); 
-        undoaddress = Undo[undonumber-1].address;
-        undo_undopossible++; 
-        undo_redopossible--;
-        if(undonumber<39 && Undo[undonumber].redopresent==0) { undo_redopossible=0; }
-        if(undonumber==39 && Undo[0].redopresent==0) { undo_redopossible=0; }
-        //cprintf("NN: %u NA: %4X UP: %u RP: %u    ",undonumber,undoaddress,undo_undopossible,undo_redopossible); 
     }
+    if(!grow)
+    {
+        undo_close();
+        undo_txrow = row;
+        undo_txcol = col;
+        undo_txwidth = 1;
+        undo_txcapture(0);
+        undo_transaction = 1;
+        undo_setflags();
+    }
+    undo_lastedit = now;
+}
+
+void undo_end()
+{
+    // Function to end the running undo transaction, on mode exit, cursor jump or word end
+
+    if(undo_transaction) { undo_close(); }
+}
+
+void undo_escapeundo()
+{
+    // Function to cancel the pending undo record after escape is pressed in selectmode or movemode
+
+    undo_pending = 0;
+    undo_transaction = 0;
+    undo_setflags();
+}
+
+void undo_performredo()
+{
+    // Function to perform an redo if a filled redo slot is present
+
+    undo_close();
+    if(undo_position < undo_count)
+    {
+        undo_apply(undo_position++);
+    }
+    undo_setflags();
 }
 
 // Help screens
@@ -1051,6 +2014,8 @@ void helpscreen_load(unsigned char screennumber)
     // Function to show selected help screen
     // Input: screennumber: 1-Main mode, 2-Character editor, 3-SelectMoveLinebox, 4-Write/colorwrite mode
 
+    unsigned int address;
+
     // Load system charset if needed
     if(charsetchanged[1] == 1)
     {
@@ -1061,11 +2026,22 @@ void helpscreen_load(unsigned char screennumber)
     VDC_BackColor(VDC_BLACK);
     cursor(0);
 
-    // Load selected help screen
+    // Load selected help screen, from REU if stored there after an earlier load
     sprintf(buffer,"vdcse.hsc%u",screennumber);
+    address = REUHELPSCREENS + ((screennumber-1)*REUHELPSIZE);
 
-    if(VDC_LoadScreen(buffer,bootdevice,WINDOWBASEADDRESS,1)>WINDOWBASEADDRESS)
+    if(helpscreensinreu & (1<<(screennumber-1)))
     {
+        REU_Transfer(REU_FETCH,WINDOWBASEADDRESS,1,address,REUBANK_OVERLAY,4048);
+        VDC_CopyMemToVDC(VDCBASETEXT,WINDOWBASEADDRESS,1,4048);
+    }
+    else if(VDC_LoadScreen(buffer,bootdevice,WINDOWBASEADDRESS,1)>WINDOWBASEADDRESS)
+    {
+        if(reubanks)
+        {
+            REU_Transfer(REU_STASH,WINDOWBASEADDRESS,1,address,REUBANK_OVERLAY,4048);
+            helpscreensinreu |= 1<<(screennumber-1);
+        }
         VDC_CopyMemToVDC(VDCBASETEXT,WINDOWBASEADDRESS,1,4048);
     }
     else
@@ -1077,7 +2053,7 @@ void helpscreen_load(unsigned char screennumber)
 
     // Restore screen
     VDC_BackColor(screenbackground);
-    VDC_CopyViewPortToVDC(SCREENMAPBASE,1,screenwidth,screenheight,xoffset,yoffset,0,0,80,25);
+    viewportrefresh();
     if(showbar) { initstatusbar(); }
     if(screennumber!=2)
     {
@@ -1094,36 +2070,31 @@ void helpscreen_load(unsigned char screennumber)
 }
 
 // Application routines
-void plotmove(unsigned char direction)
+void plotmovesteps(unsigned char direction, unsigned char steps)
 {
-    // Drive cursor move
-    // Input: ASCII code of cursor key pressed
+    // Drive cursor move of a number of steps
+    // Input: ASCII code of cursor key and number of steps
 
-    VDC_Plot(screen_row,screen_col,PEEKB(screenmap_screenaddr(yoffset+screen_row,xoffset+screen_col,screenwidth),1),PEEKB(screenmap_attraddr(yoffset+screen_row,xoffset+screen_col,screenwidth,screenheight),1));
+    VDC_Plot(screen_row,screen_col,screenmap_peek(SCREENMAP_SCREENADDR(yoffset+screen_row,xoffset+screen_col)),screenmap_peekattr(yoffset+screen_row,xoffset+screen_col));
+    cursormovesteps(direction,steps);
+    VDC_Plot(screen_row,screen_col,plotscreencode,VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
+}
 
-    switch (direction)
-    {
-    case CH_CURS_LEFT:
-        cursormove(1,0,0,0);
-        break;
-    
-    case CH_CURS_RIGHT:
-        cursormove(0,1,0,0);
-        break;
+void plotmove(unsigned char direction)
+{
+    // Drive cursor move of one step, also used to advance after writing a character
+    // Input: ASCII code of cursor key
 
-    case CH_CURS_UP:
-        cursormove(0,0,1,0);
-        break;
+    plotmovesteps(direction,1);
+}
 
-    case CH_CURS_DOWN:
-        cursormove(0,0,0,1);
-        break;
-    
-    default:
-        break;
-    }
+void plotmovekey(unsigned char key)
+{
+    // Drive cursor move for a cursor key read from the keyboard
+    // Auto repeated presses of the same key pending in the keyboard buffer are folded into one move
+    // Input: ASCII code of cursor key pressed
 
-    VDC_Plot(screen_row,screen_col,plotscreencode,VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
+    plotmovesteps(key,cursorkeycount(key));
 }
 
 void change_plotcolor(unsigned char newval)
@@ -1169,34 +2140,38 @@ void showchareditgrid(unsigned int screencode, unsigned char stdoralt)
 {
     // Function to draw grid with present char to edit
 
-    unsigned char x,y,char_byte,colorbase,colorbit;
-    unsigned int address;
+    unsigned char x,y,char_byte,colorbase;
+    unsigned char gridattr[8];
+    unsigned int address, gridaddress;
 
     address = charaddress(screencode,stdoralt,0);
     
     colorbase = mc_menupopup - (VDC_A_ALTCHAR*stdoralt);
 
     sprintf(buffer,"Char %2X %s",screencode,(stdoralt==0)? "Std":"Alt");
-    VDC_PrintAt(1,68,buffer,colorbase);
+    VDC_CmdPrintAt(1,68,buffer,colorbase);
 
     for(y=0;y<8;y++)
     {
         char_byte = VDC_Peek(address+y);
         sprintf(buffer,"%2X",char_byte);
-        VDC_PrintAt(y+3,68,buffer,colorbase);
+        VDC_CmdPrintAt(y+3,68,buffer,colorbase);
         for(x=0;x<8;x++)
         {
             if(char_byte & (1<<(7-x)))
             {
-                colorbit = colorbase;
+                gridattr[x] = colorbase;
             }
             else
             {
-                colorbit = colorbase-VDC_A_REVERSE;
+                gridattr[x] = colorbase-VDC_A_REVERSE;
             }
-            VDC_Plot(y+3,x+71,CH_SPACE,colorbit);
         }
+        gridaddress = VDC_RowColToAddress(y+3,71);
+        VDC_CmdFill(gridaddress,CH_SPACE,8);
+        VDC_CmdString(gridaddress+VDC_attroffset,gridattr,8);
     }
+    VDC_CmdRun();
 }
 
 
@@ -1216,12 +2191,12 @@ void mainmenuloop()
         {
         case 11:
             loadoverlay(1);
-            resizewidth();
+            resizecanvas(0);
             break;
 
         case 12:
-            loadoverlay(2);
-            resizeheight();
+            loadoverlay(1);
+            resizecanvas(1);
             break;
         
         case 13:
@@ -1233,7 +2208,7 @@ void mainmenuloop()
             if(undoenabled == 1) { undo_new(0,0,screenwidth,screenheight); }
             screenmapfill(CH_SPACE,VDC_WHITE);
             windowrestore(0);
-            VDC_CopyViewPortToVDC(SCREENMAPBASE,1,screenwidth,screenheight,xoffset,yoffset,0,0,80,25);
+            dirty_refresh();
             windowsave(0,1,0);
             menuplacebar();
             if(showbar) { initstatusbar(); }
@@ -1243,49 +2218,64 @@ void mainmenuloop()
             if(undoenabled == 1) { undo_new(0,0,screenwidth,screenheight); }
             screenmapfill(plotscreencode,VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
             windowrestore(0);
-            VDC_CopyViewPortToVDC(SCREENMAPBASE,1,screenwidth,screenheight,xoffset,yoffset,0,0,80,25);
+            dirty_refresh();
+            windowsave(0,1,0);
+            menuplacebar();
+            if(showbar) { initstatusbar(); }
+            break;
+
+        case 16:
+            if(!monochrome && areyousure("Drop all colours?",0) != 1) { break; }
+            if(!screenmap_setmonochrome(!monochrome))
+            {
+                messagepopup("Too large for colour.",0);
+                break;
+            }
+            sprintf(pulldownmenutitles[0][5],"Mono:      %s",(monochrome==1)? "On ":"Off");
+            windowrestore(0);
+            dirty_refresh();
             windowsave(0,1,0);
             menuplacebar();
             if(showbar) { initstatusbar(); }
             break;
 
         case 21:
-            loadoverlay(3);
+            loadoverlay(5);
             savescreenmap();
             break;
 
         case 22:
-            loadoverlay(3);
+            loadoverlay(5);
             loadscreenmap();
             break;
         
         case 23:
-            loadoverlay(3);
+            loadoverlay(5);
             saveproject();
             break;
         
         case 24:
-            loadoverlay(3);
+            loadoverlay(5);
             loadproject();
             break;
         
         case 31:
-            loadoverlay(3);
+            loadoverlay(5);
             loadcharset(0);
             break;
         
         case 32:
-            loadoverlay(3);
+            loadoverlay(5);
             loadcharset(1);
             break;
         
         case 33:
-            loadoverlay(3);
+            loadoverlay(5);
             savecharset(0);
             break;
 
         case 34:
-            loadoverlay(3);
+            loadoverlay(5);
             savecharset(1);
             break;
 
@@ -1300,12 +2290,25 @@ void mainmenuloop()
             break;
         
         case 43:
+            mapalign = (mapalign==0)? 1:0;
+            if(!screenmap_setlayout(mapalign) && mapalign)
+            {
+                mapalign = 0;
+                messagepopup("Aligned not possible.",0);
+            }
+            canvas_relayout();
+            break;
+
+        case 44:
             undoenabled = (undoenabled==0)? 1:0;
-            sprintf(pulldownmenutitles[3][2],"Undo: %s",(undoenabled==1)? "Enabled  ":"Disabled ");
-            undoaddress = VDCEXTENDED;                              // Reset undo address
-            undonumber = 0;                                         // Reset undo number
-            undo_undopossible = 0;                                  // Reset undo possible flag
-            undo_redopossible = 0;
+            sprintf(pulldownmenutitles[3][3],"Undo: %s",(undoenabled==1)? "Enabled  ":"Disabled ");
+            undo_reset(undostart,undoend);                          // Empty undo journal
+            break;
+
+        case 45:
+            canvasenabled = (canvasenabled==0)? 1:0;
+            sprintf(pulldownmenutitles[3][4],"HW scroll: %s",(canvasenabled==1)? "On ":"Off");
+            canvas_configure();
             break;
 
         default:
@@ -1334,7 +2337,7 @@ void main()
     yoffset = 0;
     screenwidth = 80;
     screenheight = 25;
-    screentotal = screenwidth*screenheight;
+    screenmap_settables();
     screenbackground = 0;
     plotscreencode = 0;
     plotcolor = VDC_WHITE;
@@ -1362,19 +2365,29 @@ void main()
 
     // Detect VDC memory size and set VDC memory config size to 64K if present
     vdcmemory = VDC_DetectVDCMemSize();
+    VDC_MemInit(vdcmemory);                                     // Register fixed VDC memory regions
     if(vdcmemory==64)
     {
         VDC_SetExtendedVDCMemSize();                            // Enable VDC 64KB extended memory
         clrscr();                                               // Clear screen to reset screen data
-        strcpy(pulldownmenutitles[3][2],"Undo: Enabled  ");     // Enable undo menuoption
-        pulldownmenuoptions[3]=3;                               // Enable undo menupotion
+        strcpy(pulldownmenutitles[3][3],"Undo: Enabled  ");     // Enable undo menuoption
+        pulldownmenuoptions[3]=4;                               // Enable undo menupotion
         undoenabled = 1;                                        // Set undo enabled flag
-        undoaddress = VDCEXTENDED;                              // Reset undo address
-        undonumber = 0;                                         // Reset undo number
-        undo_undopossible = 0;                                  // Reset undo possible flag
-        undo_redopossible = 0;                                  // Reset redo possible flag
+        strcpy(pulldownmenutitles[3][4],"HW scroll: On  ");     // Enable hardware scroll menuoption
+        pulldownmenuoptions[3]=5;                               // Enable hardware scroll menuoption
+        canvasenabled = 1;                                      // Set hardware scroll enabled flag
     }
 
+    // Detect REU, used for overlays, help screens and undo if present
+    reubanks = REU_Detect();
+    if(reubanks > REUBANK_UNDO && vdcmemory!=64)
+    {
+        strcpy(pulldownmenutitles[3][3],"Undo: Enabled  ");     // Enable undo menuoption
+        pulldownmenuoptions[3]=4;                               // Enable undo menupotion
+        undoenabled = 1;                                        // Set undo enabled flag
+    }
+    if(undoenabled) { canvas_configure(); }                     // Place canvas copy and reset undo
+
     // Copy charsets from ROM
     VDC_CopyCharsetsfromROM();
 
@@ -1421,6 +2434,7 @@ void main()
 
     do
     {
+        canvas_show();
         if(showbar) { printstatusbar(); }
         key = cgetc();
 
@@ -1431,7 +2445,7 @@ void main()
         case CH_CURS_RIGHT:
         case CH_CURS_UP:
         case CH_CURS_DOWN:
-            plotmove(key);
+            plotmovekey(key);
             break;
         
         // Increase screencode
@@ -1492,20 +2506,22 @@ void main()
 
         // Character eddit mode
         case 'e':
+            canvas_hide(0);
             loadoverlay(4);
             chareditor();
             break;
 
         // Palette for character selection
         case 'p':
+            canvas_hide(0);
             loadoverlay(1);
             palette();
             break;
 
         // Grab underlying character and attributes
         case 'g':
-            plotscreencode = PEEKB(screenmap_screenaddr(screen_row+yoffset,screen_col+xoffset,screenwidth),1);
-            newval = PEEKB(screenmap_attraddr(screen_row+yoffset,screen_col+xoffset,screenwidth,screenheight),1);
+            plotscreencode = screenmap_peek(SCREENMAP_SCREENADDR(screen_row+yoffset,screen_col+xoffset));
+            newval = screenmap_peekattr(screen_row+yoffset,screen_col+xoffset);
             if(newval>128) { plotaltchar = 1; newval -= 128; } else { plotaltchar = 0; }
             if(newval>64) { plotreverse = 1; newval -= 64; } else { plotreverse = 0; }
             if(newval>32) { plotunderline = 1; newval -= 32; } else { plotunderline = 0; }
@@ -1517,46 +2533,53 @@ void main()
 
         // Write mode: type in screencodes
         case 'w':
+            canvas_hide(1);
             loadoverlay(1);
             writemode();
             break;
         
         // Color mode: type colors
         case 'c':
+            if(monochrome) { break; }
+            canvas_hide(1);
             loadoverlay(1);
             colorwrite();
             break;
 
         // Line and box mode
         case 'l':
+            canvas_hide(1);
             loadoverlay(2);
             lineandbox(1);
             break;
 
         // Move mode
         case 'm':
+            canvas_hide(1);
             loadoverlay(2);
             movemode();
             break;
 
         // Select mode
         case 's':
+            canvas_hide(1);
             loadoverlay(2);
             selectmode();
             break;
 
         // Undo
         case 'z':
-            if(undoenabled==1 && undo_undopossible>0) { undo_performundo(); }
+            if(undoenabled==1 && undo_undopossible>0) { canvas_hide(1); undo_performundo(); }
             break;
         
         // Redo
         case 'y':
-            if(undoenabled==1 && undo_redopossible>0) { undo_performredo(); }
+            if(undoenabled==1 && undo_redopossible>0) { canvas_hide(1); undo_performredo(); }
             break;
 
         // Try
         case 't':
+            canvas_hide(1);
             loadoverlay(3);
             plot_try();
             break;
@@ -1581,17 +2604,32 @@ void main()
 
         // Go to upper left corner
         case CH_HOME:
+            if(canvasactive)
+            {
+                if(showbar) { hidestatusbar(); }
+                VDC_Plot(screen_row,screen_col,screenmap_peek(SCREENMAP_SCREENADDR(yoffset+screen_row,xoffset+screen_col)),screenmap_peekattr(yoffset+screen_row,xoffset+screen_col));
+            }
             screen_row = 0;
             screen_col = 0;
             yoffset = 0;
             xoffset = 0;
-            VDC_CopyViewPortToVDC(SCREENMAPBASE,1,screenwidth,screenheight,xoffset,yoffset,screen_col,screen_row,80,25);
+            if(canvasactive)
+            {
+                canvas_setview();
+                VDC_Plot(screen_row,screen_col,plotscreencode,VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
+            }
+            else
+            {
+                viewportrefresh();
+            }
             if(showbar) { initstatusbar(); }
             gotoxy(screen_col,screen_row);
+            if(canvasactive) { VDC_CursorAt(screen_row,screen_col); }
             break;
 
         // Go to menu
         case CH_F1:
+            canvas_hide(1);
             cursor(0);
             mainmenuloop();
             VDC_Plot(screen_row,screen_col,plotscreencode,VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
@@ -1607,6 +2645,7 @@ void main()
 
         // Help screen
         case CH_F8:
+            canvas_hide(0);
             helpscreen_load(1);
             break;
         
@@ -87,12 +87,13 @@ void writemode()
 
         switch (key)
         {
-        // Cursor move
+        // Cursor move, ends undo transaction
         case CH_CURS_LEFT:
         case CH_CURS_RIGHT:
         case CH_CURS_UP:
         case CH_CURS_DOWN:
-            plotmove(key);
+            undo_end();
+            plotmovekey(key);
             break;
 
         // Toggle blink
@@ -121,7 +122,7 @@ void writemode()
 
         // Delete present screencode and attributes
         case CH_DEL:
-            if(undoenabled == 1) { undo_new(screen_row+yoffset,screen_col+xoffset,1,1); }
+            undo_begin(screen_row+yoffset,screen_col+xoffset);
             screenmapplot(screen_row+yoffset,screen_col+xoffset,CH_SPACE,VDC_WHITE);
             VDC_Plot(screen_row,screen_col,CH_SPACE,VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
             break;
@@ -223,14 +224,16 @@ void writemode()
         default:
             if(isprint(key))
             {
-                if(undoenabled == 1) { undo_new(screen_row+yoffset,screen_col+xoffset,1,1); }
+                undo_begin(screen_row+yoffset,screen_col+xoffset);
                 if(rvs==0) { screencode = VDC_PetsciiToScreenCode(key); } else { screencode = VDC_PetsciiToScreenCodeRvs(key); }
                 screenmapplot(screen_row+yoffset,screen_col+xoffset,screencode,VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
                 plotmove(CH_CURS_RIGHT);
+                if(key==CH_SPACE) { undo_end(); }           // Undo steps by word
             }
             break;
         }
     } while (key != CH_ESC && key != CH_STOP);
+    undo_end();
     strcpy(programmode,"Main");
 }
 
@@ -247,24 +250,25 @@ void colorwrite()
         key = cgetc();
 
         // Get old attribute value
-        attribute = PEEKB(screenmap_attraddr(screen_row+yoffset,screen_col+xoffset,screenwidth,screenheight),1);
+        attribute = screenmap_peekattr(screen_row+yoffset,screen_col+xoffset);
 
         switch (key)
         {
 
-        // Cursor move
+        // Cursor move, ends undo transaction
         case CH_CURS_LEFT:
         case CH_CURS_RIGHT:
         case CH_CURS_UP:
         case CH_CURS_DOWN:
-            plotmove(key);
+            undo_end();
+            plotmovekey(key);
             break;
 
         // Toggle blink
         case CH_F1:
             attribute ^= 0x10;           // Toggle bit 4 for blink
-            if(undoenabled == 1) { undo_new(screen_row+yoffset,screen_col+xoffset,1,1); }
-            POKEB(screenmap_attraddr(screen_row+yoffset,screen_col+xoffset,screenwidth,screenheight),1,attribute);
+            undo_begin(screen_row+yoffset,screen_col+xoffset);
+            screenmap_pokeattr(screen_row+yoffset,screen_col+xoffset,attribute);
             plotmove(CH_CURS_RIGHT);
             break;
 
@@ -281,23 +285,23 @@ void colorwrite()
         // Toggle underline
         case CH_F3:
             attribute ^= 0x20;           // Toggle bit 5 for underline
-            if(undoenabled == 1) { undo_new(screen_row+yoffset,screen_col+xoffset,1,1); }
-            POKEB(screenmap_attraddr(screen_row+yoffset,screen_col+xoffset,screenwidth,screenheight),1,attribute);
+            undo_begin(screen_row+yoffset,screen_col+xoffset);
+            screenmap_pokeattr(screen_row+yoffset,screen_col+xoffset,attribute);
             plotmove(CH_CURS_RIGHT);
             break;
 
         // Toggle reverse
         case CH_F5:
             attribute ^= 0x40;           // Toggle bit 6 for reverse
-            if(undoenabled == 1) { undo_new(screen_row+yoffset,screen_col+xoffset,1,1); }
-            POKEB(screenmap_attraddr(screen_row+yoffset,screen_col+xoffset,screenwidth,screenheight),1,attribute);
+            undo_begin(screen_row+yoffset,screen_col+xoffset);
+            screenmap_pokeattr(screen_row+yoffset,screen_col+xoffset,attribute);
             plotmove(CH_CURS_RIGHT);
 
         // Toggle alternate character set
         case CH_F7:
             attribute ^= 0x80;           // Toggle bit 7 for alternate charset
-            if(undoenabled == 1) { undo_new(screen_row+yoffset,screen_col+xoffset,1,1); }
-            POKEB(screenmap_attraddr(screen_row+yoffset,screen_col+xoffset,screenwidth,screenheight),1,attribute);
+            undo_begin(screen_row+yoffset,screen_col+xoffset);
+            screenmap_pokeattr(screen_row+yoffset,screen_col+xoffset,attribute);
             plotmove(CH_CURS_RIGHT);
             break;
         
@@ -316,21 +320,22 @@ void colorwrite()
             {
                 attribute &= 0xf0;                  // Erase bits 0-3
                 attribute += (key -48);             // Add color 0-9 with key 0-9
-                if(undoenabled == 1) { undo_new(screen_row+yoffset,screen_col+xoffset,1,1); }
-                POKEB(screenmap_attraddr(screen_row+yoffset,screen_col+xoffset,screenwidth,screenheight),1,attribute);
+                undo_begin(screen_row+yoffset,screen_col+xoffset);
+                screenmap_pokeattr(screen_row+yoffset,screen_col+xoffset,attribute);
                 plotmove(CH_CURS_RIGHT);
             }
             if(key>64 && key<71)
             {
                 attribute &= 0xf0;                  // Erase bits 0-3
                 attribute += (key -55);             // Add color 10-15 with key A-F
-                if(undoenabled == 1) { undo_new(screen_row+yoffset,screen_col+xoffset,1,1); }
-                POKEB(screenmap_attraddr(screen_row+yoffset,screen_col+xoffset,screenwidth,screenheight),1,attribute);
+                undo_begin(screen_row+yoffset,screen_col+xoffset);
+                screenmap_pokeattr(screen_row+yoffset,screen_col+xoffset,attribute);
                 plotmove(CH_CURS_RIGHT);
             }
             break;
         }
     } while (key != CH_ESC && key != CH_STOP);
+    undo_end();
     strcpy(programmode,"Main");
 }
 
@@ -547,68 +552,60 @@ void palette()
     strcpy(programmode,"Main");
 }
 
-void resizewidth()
+void resizecanvas(unsigned char height)
 {
-    // Function to resize screen canvas width
+    // Function to resize screen canvas width or height
+    // Input: resize the width (0) or the height (1)
 
+    unsigned int oldsize = (height)? screenheight : screenwidth;
+    unsigned int newsize;
     unsigned int newwidth = screenwidth;
-    unsigned int maxsize = MEMORYLIMIT - SCREENMAPBASE;
+    unsigned int newheight = screenheight;
     unsigned char areyousure = 0;
     unsigned char sizechanged = 0;
-    unsigned int y;
+    unsigned char anchor = 0;
+    unsigned char keepkey = (height)? 't' : 'l';
+    unsigned char movekey = (height)? 'b' : 'r';
+    unsigned char key;
     char* ptrend;
 
     windownew(20,5,12,40,0);
 
-    VDC_PrintAt(6,21,"Resize canvas width",mc_menupopup+VDC_A_UNDERLINE);
-    VDC_PrintAt(8,21,"Enter new width:",mc_menupopup);
+    VDC_PrintAt(6,21,(height)? "Resize canvas height" : "Resize canvas width",mc_menupopup+VDC_A_UNDERLINE);
+    VDC_PrintAt(8,21,(height)? "Enter new height:" : "Enter new width:",mc_menupopup);
 
-    sprintf(buffer,"%i",screenwidth);
+    sprintf(buffer,"%i",oldsize);
     textInput(21,9,buffer,4);
-    newwidth = (unsigned int)strtol(buffer,&ptrend,10);
+    newsize = (unsigned int)strtol(buffer,&ptrend,10);
+    if(height) { newheight = newsize; } else { newwidth = newsize; }
 
-    if((newwidth*screenheight*2) + 48 > maxsize || newwidth<80 )
+    if(!screenmap_storage(newwidth,newheight) || newsize < ((height)? 25 : 80))
     {
         VDC_PrintAt(11,21,"New size unsupported. Press key.",mc_menupopup);
         cgetc();
     }
-    else
+    else if(newsize != oldsize)
     {
-        if(newwidth < screenwidth)
+        VDC_PrintAt(10,21,(height)? "Keep content at (T)op or (B)ottom?" : "Keep content at (L)eft or (R)ight?",mc_menupopup);
+        do
+        {
+            key = cgetc();
+        } while (key != keepkey && key != movekey && key != CH_ESC && key != CH_STOP);
+        if(key == movekey) { anchor = (height)? RESIZE_ANCHORBOTTOM : RESIZE_ANCHORRIGHT; }
+
+        // ESC or STOP cancels the resize
+        if(key != CH_ESC && key != CH_STOP) { areyousure = 1; }
+        if(areyousure && newsize < oldsize)
         {
             VDC_PrintAt(11,21,"Shrinking might delete data.",mc_menupopup);
             VDC_PrintAt(12,21,"Are you sure?",mc_menupopup);
             areyousure = menupulldown(25,13,5,0);
-            if(areyousure==1)
-            {
-                for(y=1;y<screenheight;y++)
-                {
-                    VDC_CopyMemToVDC(VDCSWAPTEXT,screenmap_screenaddr(y,0,screenwidth),1,newwidth);
-                    VDC_CopyVDCToMem(VDCSWAPTEXT,screenmap_screenaddr(y,0,newwidth),1,newwidth);
-                }
-                for(y=0;y<screenheight;y++)
-                {
-                    VDC_CopyMemToVDC(VDCSWAPTEXT,screenmap_attraddr(y,0,screenwidth,screenheight),1,newwidth);
-                    VDC_CopyVDCToMem(VDCSWAPTEXT,screenmap_attraddr(y,0,newwidth,screenheight),1,newwidth);
-                }
-                if(screen_col>newwidth-1) { screen_col=newwidth-1; }
-                sizechanged = 1;
-            }
         }
-        if(newwidth > screenwidth)
+        if(areyousure==1)
         {
-            for(y=0;y<screenheight;y++)
-            {
-                VDC_CopyMemToVDC(VDCSWAPTEXT,screenmap_attraddr(screenheight-y-1,0,screenwidth,screenheight),1,screenwidth);
-                VDC_CopyVDCToMem(VDCSWAPTEXT,screenmap_attraddr(screenheight-y-1,0,newwidth,screenheight),1,screenwidth);
-                BankMemSet(screenmap_attraddr(screenheight-y-1,screenwidth,newwidth,screenheight),1,VDC_WHITE,newwidth-screenwidth);
-            }
-            for(y=0;y<screenheight;y++)
-            {
-                VDC_CopyMemToVDC(VDCSWAPTEXT,screenmap_screenaddr(screenheight-y-1,0,screenwidth),1,screenwidth);
-                VDC_CopyVDCToMem(VDCSWAPTEXT,screenmap_screenaddr(screenheight-y-1,0,newwidth),1,screenwidth);
-                BankMemSet(screenmap_screenaddr(screenheight-y-1,screenwidth,newwidth),1,CH_SPACE,newwidth-screenwidth);
-            }
+            screenmap_resize(newwidth,newheight,anchor);
+            if(screen_col>newwidth-1) { screen_col=newwidth-1; }
+            if(screen_row>newheight-1) { screen_row=newheight-1; }
             sizechanged = 1;
         }
     }
@@ -617,15 +614,12 @@ void resizewidth()
 
     if(sizechanged==1)
     {
-        screenwidth = newwidth;
-        screentotal = screenwidth * screenheight;
-        xoffset = 0;
-        placesignature();
-        VDC_CopyViewPortToVDC(SCREENMAPBASE,1,screenwidth,screenheight,xoffset,yoffset,0,0,80,25);
+        if(height) { yoffset = 0; } else { xoffset = 0; }
+        viewportrefresh();
         sprintf(pulldownmenutitles[0][0],"Width:   %5i ",screenwidth);
+        sprintf(pulldownmenutitles[0][1],"Height:  %5i ",screenheight);
         menuplacebar();
         if(showbar) { initstatusbar(); }
-        undo_undopossible=0;
-        undo_redopossible=0;
+        canvas_configure();
     }
 }
@@ -71,7 +71,7 @@ BUT WITHOUT ANY WARRANTY. USE THEM AT YOUR OWN RISK!
 #pragma code-name ("OVERLAY2");
 #pragma rodata-name ("OVERLAY2");
 
-void plotvisible(unsigned char row, unsigned char col, unsigned char setorrestore)
+void plotvisible(unsigned int row, unsigned int col, unsigned char setorrestore)
 {
     // Plot or erase part of line or box if in visible viewport
     // Input: row, column, and flag setorrestore to plot new value (1) or restore old value (0)
@@ -85,7 +85,7 @@ void plotvisible(unsigned char row, unsigned char col, unsigned char setorrestor
         }
         else
         {
-            VDC_Plot(row-yoffset, col-xoffset,PEEKB(screenmap_screenaddr(row,col,screenwidth),1),PEEKB(screenmap_attraddr(row,col,screenwidth,screenheight),1));
+            VDC_Plot(row-yoffset, col-xoffset,screenmap_peek(SCREENMAP_SCREENADDR(row,col)),screenmap_peekattr(row,col));
         }
     }
 }
@@ -96,7 +96,7 @@ void lineandbox(unsigned char draworselect)
     // Input: draworselect: Choose select mode (0) or draw mode (1)
 
     unsigned char key;
-    unsigned char x,y;
+    unsigned int x,y;
 
     select_startx = screen_col + xoffset;
     select_starty = screen_row + yoffset;
@@ -181,17 +181,15 @@ void lineandbox(unsigned char draworselect)
 
     if(key==CH_ENTER && draworselect ==1)
     {
-        for(y=select_starty;y<select_endy+1;y++)
-        {
-            BankMemSet(screenmap_screenaddr(y,select_startx,screenwidth),1,plotscreencode,select_width);
-            BankMemSet(screenmap_attraddr(y,select_startx,screenwidth,screenheight),1,VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse,plotaltchar),select_width);
-        }
+        BankRectSet(SCREENMAP_SCREENADDR(select_starty,select_startx),screenpitch,screenmapbank,plotscreencode,select_width,select_height);
+        if(!monochrome) { BankRectSet(SCREENMAP_ATTRADDR(select_starty,select_startx),screenpitch,screenmapbank,VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse,plotaltchar),select_width,select_height); }
         VDC_Plot(screen_row,screen_col,plotscreencode,VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
     }
     else
     {
-        VDC_CopyViewPortToVDC(SCREENMAPBASE,1,screenwidth,screenheight,xoffset,yoffset,0,0,80,25);
-        if(showbar) { initstatusbar(); }
+        // Restore the area covered by the selection box
+        dirty_mark(select_starty,select_startx,select_endx-select_startx+1,select_endy-select_starty+1);
+        if(dirty_refresh() && showbar) { initstatusbar(); }
         if(key==CH_ENTER) { select_accept=1; }
     }
     if(draworselect)
@@ -210,10 +208,10 @@ void movemode()
     strcpy(programmode,"Move");
 
     cursor(0);
-    VDC_Plot(screen_row,screen_col,PEEKB(screenmap_screenaddr(yoffset+screen_row,xoffset+screen_col,screenwidth),1),PEEKB(screenmap_attraddr(yoffset+screen_row,xoffset+screen_col,screenwidth,screenheight),1));
+    VDC_Plot(screen_row,screen_col,screenmap_peek(SCREENMAP_SCREENADDR(yoffset+screen_row,xoffset+screen_col)),screenmap_peekattr(yoffset+screen_row,xoffset+screen_col));
     
 
-    if(undoenabled == 1) { undo_new(0,0,80,25); }
+    if(undoenabled == 1) { undo_new(yoffset,xoffset,80,25); }
     if(showbar) { hidestatusbar(); }
 
     do
@@ -261,11 +259,11 @@ void movemode()
         {
             for(y=0;y<25;y++)
             {
-                VDC_CopyVDCToMem(VDCBASETEXT+(y*80),screenmap_screenaddr(y+yoffset,xoffset,screenwidth),1,80);
-                VDC_CopyVDCToMem(VDCBASEATTR+(y*80),screenmap_attraddr(y+yoffset,xoffset,screenwidth,screenheight),1,80);
+                VDC_CopyVDCToMem(VDCBASETEXT+(y*80),SCREENMAP_SCREENADDR(y+yoffset,xoffset),screenmapbank,80);
+                if(!monochrome) { VDC_CopyVDCToMem(VDCBASEATTR+(y*80),SCREENMAP_ATTRADDR(y+yoffset,xoffset),screenmapbank,80); }
             }
         }
-        VDC_CopyViewPortToVDC(SCREENMAPBASE,1,screenwidth,screenheight,xoffset,yoffset,0,0,80,25);
+        viewportrefresh();
         if(showbar) { initstatusbar(); }
     }
     else
@@ -279,11 +277,70 @@ void movemode()
     if(showbar) { printstatusbar(); }
 }
 
+void select_clear(unsigned int row, unsigned int col, unsigned int width, unsigned int height)
+{
+    // Function to clear a rectangle of the screen map to spaces in white
+
+    BankRectSet(SCREENMAP_SCREENADDR(row,col),screenpitch,screenmapbank,CH_SPACE,width,height);
+    if(!monochrome) { BankRectSet(SCREENMAP_ATTRADDR(row,col),screenpitch,screenmapbank,VDC_WHITE,width,height); }
+    dirty_mark(row,col,width,height);
+}
+
+void select_clearsource(unsigned int destrow, unsigned int destcol)
+{
+    // Function to clear the part of the selection not covered by its moved copy
+    // Input: destination row and column of moved selection
+
+    unsigned int overlaprow, overlapheight;
+
+    // Clear full source if source and destination do not overlap
+    if(destrow >= select_starty+select_height || select_starty >= destrow+select_height || destcol >= select_startx+select_width || select_startx >= destcol+select_width)
+    {
+        select_clear(select_starty,select_startx,select_width,select_height);
+        return;
+    }
+
+    // Clear source rows above or below destination
+    overlaprow = select_starty;
+    overlapheight = select_height;
+    if(destrow > select_starty)
+    {
+        select_clear(select_starty,select_startx,select_width,destrow-select_starty);
+        overlaprow = destrow;
+        overlapheight -= destrow-select_starty;
+    }
+    if(destrow < select_starty)
+    {
+        select_clear(destrow+select_height,select_startx,select_width,select_starty-destrow);
+        overlapheight -= select_starty-destrow;
+    }
+
+    // Clear source columns left or right of destination in overlapping rows
+    if(destcol > select_startx)
+    {
+        select_clear(overlaprow,select_startx,destcol-select_startx,overlapheight);
+    }
+    if(destcol < select_startx)
+    {
+        select_clear(overlaprow,destcol+select_width,select_startx-destcol,overlapheight);
+    }
+}
+
+void select_transform(unsigned char andmask, unsigned char ormask, unsigned char xormask, const unsigned char* lut)
+{
+    // Function to transform the attributes of the selection in one pass
+
+    if(monochrome) { return; }
+    BankRectTransform(SCREENMAP_ATTRADDR(select_starty,select_startx),screenpitch,screenmapbank,select_width,select_height,andmask,ormask,xormask,lut);
+    dirty_mark(select_starty,select_startx,select_width,select_height);
+}
+
 void selectmode()
 {
     // Function to select a screen area to delete, cut, copy or paint
 
-    unsigned char key,movekey,x,y,ycount;
+    unsigned char key,movekey,x,y,color;
+    unsigned int top,left;
 
     strcpy(programmode,"Select");
 
@@ -291,7 +348,7 @@ void selectmode()
     lineandbox(0);
     if(select_accept == 0) { return; }
 
-    strcpy(programmode,"X/C/D/A/P?");
+    strcpy(programmode,"XCDAPBURLM");
 
     do
     {
@@ -306,16 +363,10 @@ void selectmode()
 
         if(key==CH_F8) { helpscreen_load(3); }
 
-    } while (key !='d' && key !='x' && key !='c' && key != 'p' && key !='a' && key != CH_ESC && key != CH_STOP );
+    } while (key !='d' && key !='x' && key !='c' && key != 'p' && key !='a' && key !='b' && key !='u' && key !='r' && key !='l' && key !='m' && key != CH_ESC && key != CH_STOP );
 
     if(key!=CH_ESC && key != CH_STOP)
     {
-        if((key=='x' || key=='c')&&(select_width>4096))
-        {
-            messagepopup("Selection too big.",1);
-            return;
-        }
-
         if(key=='x' || key=='c')
         {
             if(key=='x')
@@ -338,7 +389,7 @@ void selectmode()
                 case CH_CURS_RIGHT:
                 case CH_CURS_UP:
                 case CH_CURS_DOWN:
-                    plotmove(movekey);
+                    plotmovekey(movekey);
                     break;
 
                 case CH_F8:
@@ -358,51 +409,59 @@ void selectmode()
                     return;
                 }
 
-                if(key=='c' ) { undo_escapeundo(); }
-                undo_new(screen_row+yoffset,screen_col+xoffset,select_width,select_height);
-                for(ycount=0;ycount<select_height;ycount++)
+                // Cut changes source and destination, so one undo step covers both
+                undo_escapeundo();
+                if(key=='x')
                 {
-                    y=(screen_row+yoffset>=select_starty)? select_height-ycount-1 : ycount;
-                    VDC_CopyMemToVDC(VDCSWAPTEXT,screenmap_screenaddr(select_starty+y,select_startx,screenwidth),1, select_width);
-                    if(key=='x') { BankMemSet(screenmap_screenaddr(select_starty+y,select_startx,screenwidth),1,CH_SPACE,select_width); }
-                    VDC_CopyVDCToMem(VDCSWAPTEXT,screenmap_screenaddr(screen_row+yoffset+y,screen_col+xoffset,screenwidth),1,select_width);
-                    VDC_CopyMemToVDC(VDCSWAPTEXT,screenmap_attraddr(select_starty+y,select_startx,screenwidth,  screenheight),1,select_width);
-                    if(key=='x') { BankMemSet(screenmap_attraddr(select_starty+y,select_startx,screenwidth,screenheight),1,VDC_WHITE,select_width); }
-                    VDC_CopyVDCToMem(VDCSWAPTEXT,screenmap_attraddr(screen_row+yoffset+y,screen_col+xoffset,screenwidth,  screenheight),1,select_width);
+                    top = (select_starty < screen_row+yoffset)? select_starty : screen_row+yoffset;
+                    left = (select_startx < screen_col+xoffset)? select_startx : screen_col+xoffset;
+                    undo_new(top,left,(select_startx > screen_col+xoffset)? select_startx-left+select_width : screen_col+xoffset-left+select_width,(select_starty > screen_row+yoffset)? select_starty-top+select_height : screen_row+yoffset-top+select_height);
                 }
+                else
+                {
+                    undo_new(screen_row+yoffset,screen_col+xoffset,select_width,select_height);
+                }
+                BankRectCopy(SCREENMAP_SCREENADDR(select_starty,select_startx),screenpitch,SCREENMAP_SCREENADDR(screen_row+yoffset,screen_col+xoffset),screenpitch,screenmapbank,select_width,select_height);
+                if(!monochrome) { BankRectCopy(SCREENMAP_ATTRADDR(select_starty,select_startx),screenpitch,SCREENMAP_ATTRADDR(screen_row+yoffset,screen_col+xoffset),screenpitch,screenmapbank,select_width,select_height); }
+                dirty_mark(screen_row+yoffset,screen_col+xoffset,select_width,select_height);
+                if(key=='x') { select_clearsource(screen_row+yoffset,screen_col+xoffset); }
             }
         }
 
         if( key=='d')
         {
-            for(y=0;y<select_height;y++)
-            {
-                BankMemSet(screenmap_screenaddr(select_starty+y,select_startx,screenwidth),1,CH_SPACE,select_width);
-                BankMemSet(screenmap_attraddr(select_starty+y,select_startx,screenwidth,screenheight),1,VDC_WHITE,select_width);
-            }
+            select_clear(select_starty,select_startx,select_width,select_height);
         }
 
-        if(key=='a')
+        if(key=='a' && !monochrome)
         {
-            for(y=0;y<select_height;y++)
-            {
-                BankMemSet(screenmap_attraddr(select_starty+y,select_startx,screenwidth,screenheight),1,VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar),select_width);
-            }
+            BankRectSet(SCREENMAP_ATTRADDR(select_starty,select_startx),screenpitch,screenmapbank,VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar),select_width,select_height);
+            dirty_mark(select_starty,select_startx,select_width,select_height);
         }
 
         if(key=='p')
         {
-            for(y=0;y<select_height;y++)
+            select_transform(0xf0,plotcolor,0,NULL);
+        }
+
+        if(key=='b') { select_transform(0xff,0,VDC_A_BLINK,NULL); }
+        if(key=='u') { select_transform(0xff,0,VDC_A_UNDERLINE,NULL); }
+        if(key=='r') { select_transform(0xff,0,VDC_A_REVERSE,NULL); }
+        if(key=='l') { select_transform(0xff,0,VDC_A_ALTCHAR,NULL); }
+
+        if(key=='m')
+        {
+            // Remap color of first cell of selection to present color
+            color = screenmap_peekattr(select_starty,select_startx) & 0x0f;
+            x = 0;
+            do
             {
-                for(x=0;x<select_width;x++)
-                {
-                    POKEB(screenmap_attraddr(select_starty+y,select_startx+x,screenwidth,screenheight),1,(PEEKB(screenmap_attraddr(select_starty+y,select_startx+x,screenwidth,screenheight),1) & 0xf0)+plotcolor);
-                }
-            }
+                VDC_stagebuffer[x] = ((x & 0x0f) == color)? (x & 0xf0) | plotcolor : x;
+            } while (++x);
+            select_transform(0xff,0,0,VDC_stagebuffer);
         }
 
-        VDC_CopyViewPortToVDC(SCREENMAPBASE,1,screenwidth,screenheight,xoffset,yoffset,0,0,80,25);
-        if(showbar) { initstatusbar(); }
+        if(dirty_refresh() && showbar) { initstatusbar(); }
         VDC_Plot(screen_row,screen_col,plotscreencode,VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
     }
     else
@@ -410,72 +469,4 @@ void selectmode()
         undo_escapeundo();
     }
     strcpy(programmode,"Main");
-}
-
-void resizeheight()
-{
-    // Function to resize screen camvas height
-
-    unsigned int newheight = screenheight;
-    unsigned int maxsize = MEMORYLIMIT - SCREENMAPBASE;
-    unsigned char areyousure = 0;
-    unsigned char sizechanged = 0;
-    unsigned char y;
-    char* ptrend;
-
-    windownew(20,5,12,40,0);
-
-    VDC_PrintAt(6,21,"Resize canvas height",mc_menupopup+VDC_A_UNDERLINE);
-    VDC_PrintAt(8,21,"Enter new height:",mc_menupopup);
-
-    sprintf(buffer,"%i",screenheight);
-    textInput(21,9,buffer,4);
-    newheight = (unsigned int)strtol(buffer,&ptrend,10);
-
-    if((newheight*screenwidth*2) + 48 > maxsize || newheight < 25)
-    {
-        VDC_PrintAt(11,21,"New size unsupported. Press key.",mc_menupopup);
-        cgetc();
-    }
-    else
-    {
-        if(newheight < screenheight)
-        {
-            VDC_PrintAt(11,21,"Shrinking might delete data.",mc_menupopup);
-            VDC_PrintAt(12,21,"Are you sure?",mc_menupopup);
-            areyousure = menupulldown(25,13,5,0);
-            if(areyousure==1)
-            {
-                BankMemCopy(screenmap_attraddr(0,0,screenwidth,screenheight),1,screenmap_attraddr(0,0,screenwidth,newheight),1,screenheight*screenwidth);
-                if(screen_row>newheight-1) { screen_row=newheight-1; }
-                sizechanged = 1;
-            }
-        }
-        if(newheight > screenheight)
-        {
-            for(y=0;y<screenheight;y++)
-            {
-                BankMemCopy(screenmap_attraddr(screenheight-y-1,0,screenwidth,screenheight),1,screenmap_attraddr(screenheight-y-1,0,screenwidth,newheight),1,screenwidth);
-            }
-            BankMemSet(screenmap_attraddr(screenheight,0,screenwidth,newheight),1,VDC_WHITE,(newheight-screenheight)*screenwidth);
-            BankMemSet(screenmap_screenaddr(screenheight,0,screenwidth),1,CH_SPACE,(newheight-screenheight)*screenwidth);
-            sizechanged = 1;
-        }
-    }
-
-    windowrestore(0);
-
-    if(sizechanged==1)
-    {
-        screenheight = newheight;
-        screentotal = screenwidth * screenheight;
-        yoffset=0;
-        placesignature();
-        VDC_CopyViewPortToVDC(SCREENMAPBASE,1,screenwidth,screenheight,xoffset,yoffset,0,0,80,25);
-        sprintf(pulldownmenutitles[0][1],"Height:  %5i ",screenheight);
-        menuplacebar();
-        if(showbar) { initstatusbar(); }
-        undo_undopossible=0;
-        undo_redopossible=0;
-    }
 }
\ No newline at end of file
@@ -71,402 +71,6 @@ BUT WITHOUT ANY WARRANTY. USE THEM AT YOUR OWN RISK!
 #pragma code-name ("OVERLAY3");
 #pragma rodata-name ("OVERLAY3");
 
-int chooseidandfilename(char* headertext, unsigned char maxlen)
-{
-    // Function to present dialogue to enter device id and filename
-    // Input: Headertext to print, maximum length of filename input string
-
-    unsigned char newtargetdevice;
-    int valid = 0;
-    char* ptrend;
-
-    windownew(20,5,12,40,0);
-    VDC_PrintAt(6,21,headertext,mc_menupopup+VDC_A_UNDERLINE);
-    do
-    {
-        VDC_PrintAt(8,21,"Choose drive ID:",mc_menupopup);
-        sprintf(buffer,"%u",targetdevice);
-        if(textInput(21,9,buffer,2)==-1) { return -1; }
-        newtargetdevice = (unsigned char)strtol(buffer,&ptrend,10);
-        if(newtargetdevice > 7 && newtargetdevice<31)
-        {
-            valid = 1;
-            targetdevice=newtargetdevice;
-        }
-        else{
-            VDC_PrintAt(10,21,"Invalid ID. Enter valid one.",mc_menupopup);
-        }
-    } while (valid==0);
-    VDC_PrintAt(10,21,"Choose filename:            ",mc_menupopup);
-    return textInput(21,11,filename,maxlen);
-}
-
-unsigned char checkiffileexists(char* filetocheck, unsigned char id)
-{
-    // Check if file exists and, if yes, ask confirmation of overwrite
-    
-    unsigned char proceed = 1;
-    unsigned char yesno;
-    unsigned char error;
-
-    sprintf(buffer,"r0:%s=%s",filetocheck,filetocheck);
-    error = cmd(id,buffer);
-
-    if (error == 63)
-    {
-        yesno = areyousure("File exists.",0);
-        if(yesno==2)
-        {
-            proceed = 0;
-        }
-        else
-        {
-            proceed = 2;
-        }
-    } else {
-        if(error && error != 62) {
-            fileerrormessage(error,0);
-            proceed = 0;
-        }
-    }
-
-    return proceed;
-}
-
-void loadscreenmap()
-{
-    // Function to load screenmap
-
-    unsigned int lastreadaddress, newwidth, newheight;
-    unsigned int maxsize = MEMORYLIMIT - SCREENMAPBASE;
-    char* ptrend;
-    int escapeflag;
-  
-    escapeflag = chooseidandfilename("Load screen",15);
-
-    if(escapeflag==-1) { windowrestore(0); return; }
-
-    VDC_PrintAt(12,21,"Enter screen width:",mc_menupopup);
-    sprintf(buffer,"%i",screenwidth);
-    textInput(21,13,buffer,4);
-    newwidth = (unsigned int)strtol(buffer,&ptrend,10);
-
-    VDC_PrintAt(14,21,"Enter screen height:",mc_menupopup);
-    sprintf(buffer,"%i",screenheight);
-    textInput(21,15,buffer,4);
-    newheight = (unsigned int)strtol(buffer,&ptrend,10);
-
-    if((newwidth*newheight*2) + 48 > maxsize || newwidth<80 || newheight<25)
-    {
-        VDC_PrintAt(16,21,"New size unsupported. Press key.",mc_menupopup);
-        cgetc();
-        windowrestore(0);
-    }
-    else
-    {
-        windowrestore(0);
-
-        lastreadaddress = VDC_LoadScreen(filename,targetdevice,SCREENMAPBASE,1);
-
-        if(lastreadaddress>SCREENMAPBASE)
-        {
-            windowrestore(0);
-            screenwidth = newwidth;
-            screenheight = newheight;
-            VDC_CopyViewPortToVDC(SCREENMAPBASE,1,screenwidth,screenheight,xoffset,yoffset,0,0,80,25);
-            windowsave(0,1,0);
-            menuplacebar();
-            if(showbar) { initstatusbar(); }
-            undo_undopossible=0;
-            undo_redopossible=0;
-        }
-    }
-}
-
-void savescreenmap()
-{
-    // Function to save screenmap
-
-    unsigned char error, overwrite;
-    int escapeflag;
-  
-    escapeflag = chooseidandfilename("Save screen",15);
-
-    windowrestore(0);
-
-    if(escapeflag==-1) { return; }
-
-    overwrite = checkiffileexists(filename,targetdevice);
-
-    if(overwrite)
-    {
-        // Scratch old file
-        if(overwrite==2)
-        {
-            sprintf(buffer,"s:%s",filename);
-            cmd(targetdevice,buffer);
-        }
-
-        // Set device ID
-	    cbm_k_setlfs(0, targetdevice, 0);
-    
-	    // Set filename
-	    cbm_k_setnam(filename);
-    
-	    // Set bank
-	    SetLoadSaveBank(1);
-    
-	    // Load from file to memory
-	    error = cbm_k_save(SCREENMAPBASE,SCREENMAPBASE+(screenwidth*screenheight*2)+48);
-    
-	    // Restore I/O bank to 0
-	    SetLoadSaveBank(0);
-    
-        if(error) { fileerrormessage(error,0); }
-    }
-}
-
-void saveproject()
-{
-    // Function to save project (screen, charsets and metadata)
-
-    unsigned char error,overwrite;
-    char projbuffer[22];
-    char tempfilename[21];
-    int escapeflag;
-  
-    escapeflag = chooseidandfilename("Save project",10);
-
-    windowrestore(0);
-
-    if(escapeflag==-1) { return; }
-
-    sprintf(tempfilename,"%s.proj",filename);
-
-    overwrite = checkiffileexists(tempfilename,targetdevice);
-
-    if(overwrite)
-    {
-        // Scratch old files
-        if(overwrite==2)
-        {
-            sprintf(buffer,"s:%s.proj",filename);
-            cmd(targetdevice,buffer);
-            sprintf(buffer,"s:%s.scrn",filename);
-            cmd(targetdevice,buffer);
-            sprintf(buffer,"s:%s.chrs",filename);
-            cmd(targetdevice,buffer);
-            sprintf(buffer,"s:%s.chra",filename);
-            cmd(targetdevice,buffer);
-        }
-
-        // Store project data to buffer variable
-	    SetLoadSaveBank(0);
-        projbuffer[ 0] = charsetchanged[0];
-        projbuffer[ 1] = charsetchanged[1];
-        projbuffer[ 2] = screen_col;
-        projbuffer[ 3] = screen_row;
-        projbuffer[ 4] = (screenwidth>>8) & 0xff;
-        projbuffer[ 5] = screenwidth & 0xff;
-        projbuffer[ 6] = (screenheight>>8) & 0xff;
-        projbuffer[ 7] = screenheight & 0xff;
-        projbuffer[ 8] = (screentotal>>8) & 0xff;
-        projbuffer[ 9] = screentotal & 0xff;
-        projbuffer[10] = screenbackground;
-        projbuffer[11] = mc_mb_normal;
-        projbuffer[12] = mc_mb_select;
-        projbuffer[13] = mc_pd_normal;
-        projbuffer[14] = mc_pd_select;
-        projbuffer[15] = mc_menupopup;
-        projbuffer[16] = plotscreencode;
-        projbuffer[17] = plotcolor;
-        projbuffer[18] = plotreverse;
-        projbuffer[19] = plotunderline;
-        projbuffer[20] = plotblink;
-        projbuffer[21] = plotaltchar;
-	    cbm_k_setlfs(0, targetdevice, 0);
-        sprintf(buffer,"%s.proj",filename);
-	    cbm_k_setnam(buffer);
-	    error = cbm_k_save((unsigned int)projbuffer,(unsigned int)projbuffer+22);
-        if(error) { fileerrormessage(error,0); }
-
-        // Store screen data
-        SetLoadSaveBank(1);
-        cbm_k_setlfs(0, targetdevice, 0);
-        sprintf(buffer,"%s.scrn",filename);
-	    cbm_k_setnam(buffer);
-	    error = cbm_k_save(SCREENMAPBASE,SCREENMAPBASE+(screenwidth*screenheight*2)+48);
-        if(error) { fileerrormessage(error,0); }
-
-        // Store standard charset
-        if(charsetchanged[0]==1)
-        {
-            cbm_k_setlfs(0, targetdevice, 0);
-            sprintf(buffer,"%s.chrs",filename);
-	        cbm_k_setnam(buffer);
-	        error = cbm_k_save(CHARSETNORMAL,CHARSETNORMAL+256*8);
-            if(error) { fileerrormessage(error,0); }
-        }
-
-        // Store alternate charset
-        if(charsetchanged[1]==1)
-        {
-            cbm_k_setlfs(0, targetdevice, 0);
-            sprintf(buffer,"%s.chra",filename);
-	        cbm_k_setnam(buffer);
-	        error = cbm_k_save(CHARSETALTERNATE,CHARSETALTERNATE+256*8);
-            if(error) { fileerrormessage(error,0); }
-        }
-    
-	    // Restore I/O bank to 0
-	    SetLoadSaveBank(0);        
-    }
-}
-
-void loadproject()
-{
-    // Function to load project (screen, charsets and metadata)
-
-    unsigned int lastreadaddress;
-    unsigned char projbuffer[22];
-    int escapeflag;
-  
-    escapeflag = chooseidandfilename("Load project",10);
-
-    windowrestore(0);
-
-    if(escapeflag==-1) { return; }
-
-    // Load project variables
-    sprintf(buffer,"%s.proj",filename);
-	cbm_k_setlfs(0,targetdevice, 0);
-	cbm_k_setnam(buffer);
-	SetLoadSaveBank(0);
-	lastreadaddress = cbm_k_load(0,(unsigned int)projbuffer);
-    if(lastreadaddress<=(unsigned int)projbuffer) { return; }
-    charsetchanged[0]       = projbuffer[ 0];
-    charsetchanged[1]       = projbuffer[ 1];
-    screen_col              = projbuffer[ 2];
-    screen_row              = projbuffer[ 3];
-    screenwidth             = projbuffer[ 4]*256+projbuffer[ 5];
-    sprintf(pulldownmenutitles[0][0],"Width:   %5i ",screenwidth);
-    screenheight            = projbuffer[ 6]*256+projbuffer [7];
-    sprintf(pulldownmenutitles[0][1],"Height:  %5i ",screenheight);
-    screentotal             = projbuffer[ 8]*256+projbuffer[ 9];
-    screenbackground        = projbuffer[10];
-    VDC_BackColor(screenbackground);
-    sprintf(buffer,"Color: %2i",screenbackground);
-    mc_mb_normal            = projbuffer[11];
-    mc_mb_select            = projbuffer[12];
-    mc_pd_normal            = projbuffer[13];
-    mc_pd_select            = projbuffer[14];
-    mc_menupopup            = projbuffer[15];
-    plotscreencode          = projbuffer[16];
-    plotcolor               = projbuffer[17];
-    plotreverse             = projbuffer[18];
-    plotunderline           = projbuffer[19];
-    plotblink               = projbuffer[20];
-    plotaltchar             = projbuffer[21];
-
-    // Load screen
-    sprintf(buffer,"%s.scrn",filename);
-    lastreadaddress = VDC_LoadScreen(buffer,targetdevice,SCREENMAPBASE,1);
-    if(lastreadaddress>SCREENMAPBASE)
-    {
-        windowrestore(0);
-        VDC_CopyViewPortToVDC(SCREENMAPBASE,1,screenwidth,screenheight,xoffset,yoffset,0,0,80,25);
-        windowsave(0,1,0);
-        menuplacebar();
-        if(showbar) { initstatusbar(); }
-        undo_undopossible=0;
-        undo_redopossible=0;
-    }
-
-    // Load standard charset
-    if(charsetchanged[0]==1)
-    {
-        sprintf(buffer,"%s.chrs",filename);
-        VDC_LoadCharset(buffer,targetdevice,CHARSETNORMAL,1,1);
-    }
-
-    // Load standard charset
-    if(charsetchanged[1]==1)
-    {
-        sprintf(buffer,"%s.chra",filename);
-        VDC_LoadCharset(buffer,targetdevice,CHARSETALTERNATE,1,2);
-    }
-}
-
-void loadcharset(unsigned char stdoralt)
-{
-    // Function to load charset
-    // Input: stdoralt: standard charset (0) or alternate charset (1)
-
-    unsigned int lastreadaddress, charsetaddress;
-    int escapeflag;
-  
-    escapeflag = chooseidandfilename("Load character set",15);
-
-    windowrestore(0);
-
-    if(escapeflag==-1) { return; }
-
-    charsetaddress = (stdoralt==0)? CHARSETNORMAL : CHARSETALTERNATE;
-
-    lastreadaddress = VDC_LoadCharset(filename,targetdevice,charsetaddress,1,0);
-
-    if(lastreadaddress>charsetaddress)
-    {
-        if(stdoralt==0)
-        {
-            VDC_RedefineCharset(charsetaddress,1,VDCCHARSTD,255);
-        }
-        charsetchanged[stdoralt]=1;
-    }
-}
-
-void savecharset(unsigned char stdoralt)
-{
-    // Function to save charset
-    // Input: stdoralt: standard charset (0) or alternate charset (1)
-
-    unsigned char error;
-    unsigned int charsetaddress;
-    int escapeflag;
-  
-    escapeflag = chooseidandfilename("Save character set",15);
-
-    windowrestore(0);
-
-    if(escapeflag==-1) { return; }
-
-    charsetaddress = (stdoralt==0)? CHARSETNORMAL : CHARSETALTERNATE;
-
-    if(checkiffileexists(filename,targetdevice)==1)
-    {
-        // Scratch old file
-        sprintf(buffer,"s:%s",filename);
-        cmd(targetdevice,buffer);
-
-        // Set device ID
-	    cbm_k_setlfs(0, targetdevice, 0);
-
-	    // Set filename
-	    cbm_k_setnam(filename);
-
-	    // Set bank
-	    SetLoadSaveBank(1);
-    
-	    // Load from file to memory
-	    error = cbm_k_save(charsetaddress,charsetaddress+256*8);
-
-	    // Restore I/O bank to 0
-	    SetLoadSaveBank(0);
-
-        if(error) { fileerrormessage(error,0); }
-    }
-}
-
 void changebackgroundcolor()
 {
     // Function to change background color
@@ -569,16 +173,35 @@ void changebackgroundcolor()
 
 void versioninfo()
 {
-    windownew(5,5,15,60,1);
-    VDC_PrintAt(6,6,"Version information and credits",mc_menupopup+VDC_A_UNDERLINE);
-    VDC_PrintAt(8,6,"VDC Screen Editor",mc_menupopup);
-    VDC_PrintAt(9,6,"Written in 2021 by Xander Mol",mc_menupopup);
+    unsigned char x;
+
+    windownew(5,4,19,60,1);
+    VDC_PrintAt(5,6,"Version information and credits",mc_menupopup+VDC_A_UNDERLINE);
+    VDC_PrintAt(7,6,"VDC Screen Editor",mc_menupopup);
+    VDC_PrintAt(8,6,"Written in 2021 by Xander Mol",mc_menupopup);
     sprintf(buffer,"Version: %s",version);
-    VDC_PrintAt(11,6,buffer,mc_menupopup);
-    VDC_PrintAt(13,6,"Full source code, documentation and credits at:",mc_menupopup);
-    VDC_PrintAt(14,6,"https://github.com/xahmol/VDCScreenEdit",mc_menupopup);
-    VDC_PrintAt(16,6,"(C) 2021, IDreamtIn8Bits.com",mc_menupopup);
-    VDC_PrintAt(18,6,"Press a key to continue.",mc_menupopup);
+    VDC_PrintAt(9,6,buffer,mc_menupopup);
+    sprintf(buffer,"Last refresh: %u frames",VDC_refreshframes);
+    VDC_PrintAt(10,6,buffer,mc_menupopup);
+    if(reubanks)
+    {
+        sprintf(buffer,"REU: %uKB%s",reubanks*64,(undoinreu)? ", used for undo":"");
+        VDC_PrintAt(11,6,buffer,mc_menupopup);
+    }
+    VDC_PrintAt(12,6,"Full source code, documentation and credits at:",mc_menupopup);
+    VDC_PrintAt(13,6,"https://github.com/xahmol/VDCScreenEdit",mc_menupopup);
+    VDC_PrintAt(14,6,"(C) 2021, IDreamtIn8Bits.com",mc_menupopup);
+
+    // VDC memory usage report, three regions per line
+    sprintf(buffer,"VDC memory: %uKB, %u bytes free",vdcmemory,VDC_memfree);
+    VDC_PrintAt(16,6,buffer,mc_menupopup+VDC_A_UNDERLINE);
+    for(x=0;x<VDC_memregions;x++)
+    {
+        sprintf(buffer,"%-7s %04X %5u",VDC_memregion[x].name,VDC_memregion[x].address,VDC_memregion[x].size);
+        VDC_PrintAt(17+(x/3),6+((x%3)*19),buffer,mc_menupopup);
+    }
+
+    VDC_PrintAt(21,6,"Press a key to continue.",mc_menupopup);
     cgetc();
     windowrestore(0);
 }
@@ -0,0 +1,552 @@
+/*
+VDC Screen Editor
+Screen editor for the C128 80 column mode
+Written in 2021 by Xander Mol
+
+https://github.com/xahmol/VDCScreenEdit
+https://www.idreamtin8bits.com/
+
+Code and resources from others used:
+
+-   CC65 cross compiler:
+    https://cc65.github.io/
+
+-   C128 Programmers Reference Guide: For the basic VDC register routines and VDC code inspiration
+    http://www.zimmers.net/anonftp/pub/cbm/manuals/c128/C128_Programmers_Reference_Guide.pdf
+
+-   Scott Hutter - VDC Core functions inspiration:
+    https://github.com/Commodore64128/vdc_gui/blob/master/src/vdc_core.c
+    (used as starting point, but changed to inline assembler for core functions, added VDC wait statements and expanded)
+
+-   Francesco Sblendorio - Screen Utility: used for inspiration:
+    https://github.com/xlar54/ultimateii-dos-lib/blob/master/src/samples/screen_utility.c
+
+-   DevDef: Commodore 128 Assembly - Part 3: The 80-column (8563) chip
+    https://devdef.blogspot.com/2018/03/commodore-128-assembly-part-3-80-column.html
+
+-   Tips and Tricks for C128: VDC
+    http://commodore128.mirkosoft.sk/vdc.html
+
+-   6502.org: Practical Memory Move Routines: Starting point for memory move routines
+    http://6502.org/source/general/memory_move.html
+
+-   DraBrowse source code for DOS Command and text input routine
+    DraBrowse (db*) is a simple file browser.
+    Originally created 2009 by Sascha Bader.
+    Used version adapted by Dirk Jagdmann (doj)
+    https://github.com/doj/dracopy
+
+-   Bart van Leeuwen: For inspiration and advice while coding.
+    Also for providing the excellent Device Manager ROM to make testing on real hardware very easy
+
+-   jab / Artline Designs (Jaakko Luoto) for inspiration for Palette mode and PETSCII visual mode
+
+-   Original windowing system code on Commodore 128 by unknown author.
+   
+-   Tested using real hardware (C128D and C128DCR) plus VICE.
+
+The code can be used freely as long as you retain
+a notice describing original source and author.
+
+THE PROGRAMS ARE DISTRIBUTED IN THE HOPE THAT THEY WILL BE USEFUL,
+BUT WITHOUT ANY WARRANTY. USE THEM AT YOUR OWN RISK!
+*/
+
+//Includes
+#include <stdio.h>
+#include <string.h>
+#include <peekpoke.h>
+#include <cbm.h>
+#include <conio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <ctype.h>
+#include <device.h>
+#include <accelerator.h>
+#include <c128.h>
+#include "vdc_core.h"
+#include "defines.h"
+#include "main.h"
+
+#pragma code-name ("OVERLAY5");
+#pragma rodata-name ("OVERLAY5");
+
+int chooseidandfilename(char* headertext, unsigned char maxlen)
+{
+    // Function to present dialogue to enter device id and filename
+    // Input: Headertext to print, maximum length of filename input string
+
+    unsigned char newtargetdevice;
+    int valid = 0;
+    char* ptrend;
+
+    windownew(20,5,12,40,0);
+    VDC_PrintAt(6,21,headertext,mc_menupopup+VDC_A_UNDERLINE);
+    do
+    {
+        VDC_PrintAt(8,21,"Choose drive ID:",mc_menupopup);
+        sprintf(buffer,"%u",targetdevice);
+        if(textInput(21,9,buffer,2)==-1) { return -1; }
+        newtargetdevice = (unsigned char)strtol(buffer,&ptrend,10);
+        if(newtargetdevice > 7 && newtargetdevice<31)
+        {
+            valid = 1;
+            targetdevice=newtargetdevice;
+        }
+        else{
+            VDC_PrintAt(10,21,"Invalid ID. Enter valid one.",mc_menupopup);
+        }
+    } while (valid==0);
+    VDC_PrintAt(10,21,"Choose filename:            ",mc_menupopup);
+    return textInput(21,11,filename,maxlen);
+}
+
+unsigned char checkiffileexists(char* filetocheck, unsigned char id)
+{
+    // Check if file exists and, if yes, ask confirmation of overwrite
+    
+    unsigned char proceed = 1;
+    unsigned char yesno;
+    unsigned char error;
+
+    sprintf(buffer,"r0:%s=%s",filetocheck,filetocheck);
+    error = cmd(id,buffer);
+
+    if (error == 63)
+    {
+        yesno = areyousure("File exists.",0);
+        if(yesno==2)
+        {
+            proceed = 0;
+        }
+        else
+        {
+            proceed = 2;
+        }
+    } else {
+        if(error && error != 62) {
+            fileerrormessage(error,0);
+            proceed = 0;
+        }
+    }
+
+    return proceed;
+}
+
+unsigned char screenmap_loadfile(char* name, unsigned int newwidth, unsigned int newheight, unsigned char mono)
+{
+    // Function to load a screen map file of the given size to bank 1, or streamed to VDC memory if too large for bank 1
+    // Input: filename, width and height of the screen in the file, mono flag if the file has no attribute plane
+    // Output: 1 if loaded, 0 if an error occurred
+
+    unsigned char oldmono = monochrome;
+    unsigned int oldsize = SCREENMAP_SIZE;
+    unsigned char bank, overwrite = 0;
+    unsigned int size, end, start, room;
+    unsigned int base = SCREENMAPBASE;
+
+    // Storage and size of the new map depend on its planes
+    monochrome = mono;
+    bank = screenmap_storage(newwidth,newheight);
+    size = (newwidth*newheight*SCREENMAP_PLANES) + 48;
+    monochrome = oldmono;
+
+    if(!bank) { return 0; }
+
+    // Load to the new storage first, the present map is only switched to it after a successful load
+    if(bank == VDC_BANKVDC)
+    {
+        VDC_MemReset();
+        canvasbase = 0;
+        room = VDC_memfree;
+        start = base = VDC_MemAllocRest("Map");
+
+        // A present map in VDC memory starts at the same address, so load above it if there is room
+        if(screenmapbank == VDC_BANKVDC)
+        {
+            if(oldsize <= room && size <= room - oldsize) { base += oldsize; }
+            else
+            {
+                if(areyousure("Present map is replaced.",0) != 1) { canvas_configure(); return 0; }
+                overwrite = 1;
+            }
+        }
+
+        end = VDC_LoadStream(name,targetdevice,base,size);
+        if(end < base + size - 48)
+        {
+            // Present map is lost if it was overwritten, so clear it instead of showing a partial load
+            if(overwrite) { screenmapfill(CH_SPACE,VDC_WHITE); }
+            canvas_configure();
+            return 0;
+        }
+        if(base != start)
+        {
+            VDC_MemMove(base,start,end-base);
+            base = start;
+        }
+    }
+    else
+    {
+        if(VDC_LoadScreen(name,targetdevice,base,1) <= base) { return 0; }
+    }
+    screenmapbank = bank;
+    screenmapbase = base;
+    screenwidth = newwidth;
+    screenheight = newheight;
+    monochrome = mono;
+    screenmap_settables();
+    return 1;
+}
+
+unsigned char screenmap_savefile(char* name)
+{
+    // Function to save the screen map in packed layout from bank 1, or streamed from VDC memory
+    // Input: filename
+    // Output: error code
+
+    unsigned char error;
+
+    screenmap_setlayout(0);
+    if(screenmapbank == VDC_BANKVDC)
+    {
+        error = VDC_SaveStream(name,targetdevice,screenmapbase,SCREENMAP_SIZE,SCREENMAPBASE);
+    }
+    else
+    {
+        cbm_k_setlfs(0, targetdevice, 0);
+        cbm_k_setnam(name);
+        SetLoadSaveBank(1);
+        error = cbm_k_save(SCREENMAPBASE,SCREENMAPBASE+SCREENMAP_SIZE);
+        SetLoadSaveBank(0);
+    }
+    screenmap_setlayout(mapalign);
+
+    return error;
+}
+
+void loadscreenmap()
+{
+    // Function to load screenmap
+
+    unsigned int newwidth, newheight;
+    char* ptrend;
+    int escapeflag;
+  
+    escapeflag = chooseidandfilename("Load screen",15);
+
+    if(escapeflag==-1) { windowrestore(0); return; }
+
+    VDC_PrintAt(12,21,"Enter screen width:",mc_menupopup);
+    sprintf(buffer,"%i",screenwidth);
+    textInput(21,13,buffer,4);
+    newwidth = (unsigned int)strtol(buffer,&ptrend,10);
+
+    VDC_PrintAt(14,21,"Enter screen height:",mc_menupopup);
+    sprintf(buffer,"%i",screenheight);
+    textInput(21,15,buffer,4);
+    newheight = (unsigned int)strtol(buffer,&ptrend,10);
+
+    if(!screenmap_storage(newwidth,newheight) || newwidth<80 || newheight<25)
+    {
+        VDC_PrintAt(16,21,"New size unsupported. Press key.",mc_menupopup);
+        cgetc();
+        windowrestore(0);
+    }
+    else
+    {
+        windowrestore(0);
+
+        // Redraw also after an error, as a present map in VDC memory may have been cleared
+        screenmap_loadfile(filename,newwidth,newheight,monochrome);
+        windowrestore(0);
+        viewportrefresh();
+        windowsave(0,1,0);
+        menuplacebar();
+        if(showbar) { initstatusbar(); }
+        canvas_configure();
+    }
+}
+
+void savescreenmap()
+{
+    // Function to save screenmap
+
+    unsigned char error, overwrite;
+    int escapeflag;
+  
+    escapeflag = chooseidandfilename("Save screen",15);
+
+    windowrestore(0);
+
+    if(escapeflag==-1) { return; }
+
+    overwrite = checkiffileexists(filename,targetdevice);
+
+    if(overwrite)
+    {
+        // Scratch old file
+        if(overwrite==2)
+        {
+            sprintf(buffer,"s:%s",filename);
+            cmd(targetdevice,buffer);
+        }
+
+        // Save from memory to file in packed layout
+        error = screenmap_savefile(filename);
+        if(error) { fileerrormessage(error,0); }
+    }
+}
+
+void saveproject()
+{
+    // Function to save project (screen, charsets and metadata)
+
+    unsigned char error,overwrite;
+    char projbuffer[24];
+    char tempfilename[21];
+    int escapeflag;
+  
+    escapeflag = chooseidandfilename("Save project",10);
+
+    windowrestore(0);
+
+    if(escapeflag==-1) { return; }
+
+    sprintf(tempfilename,"%s.proj",filename);
+
+    overwrite = checkiffileexists(tempfilename,targetdevice);
+
+    if(overwrite)
+    {
+        // Scratch old files
+        if(overwrite==2)
+        {
+            sprintf(buffer,"s:%s.proj",filename);
+            cmd(targetdevice,buffer);
+            sprintf(buffer,"s:%s.scrn",filename);
+            cmd(targetdevice,buffer);
+            sprintf(buffer,"s:%s.chrs",filename);
+            cmd(targetdevice,buffer);
+            sprintf(buffer,"s:%s.chra",filename);
+            cmd(targetdevice,buffer);
+        }
+
+        // Store project data to buffer variable
+	    SetLoadSaveBank(0);
+        projbuffer[ 0] = charsetchanged[0];
+        projbuffer[ 1] = charsetchanged[1];
+        projbuffer[ 2] = screen_col;
+        projbuffer[ 3] = screen_row;
+        projbuffer[ 4] = (screenwidth>>8) & 0xff;
+        projbuffer[ 5] = screenwidth & 0xff;
+        projbuffer[ 6] = (screenheight>>8) & 0xff;
+        projbuffer[ 7] = screenheight & 0xff;
+        projbuffer[ 8] = (screentotal>>8) & 0xff;
+        projbuffer[ 9] = screentotal & 0xff;
+        projbuffer[10] = screenbackground;
+        projbuffer[11] = mc_mb_normal;
+        projbuffer[12] = mc_mb_select;
+        projbuffer[13] = mc_pd_normal;
+        projbuffer[14] = mc_pd_select;
+        projbuffer[15] = mc_menupopup;
+        projbuffer[16] = plotscreencode;
+        projbuffer[17] = plotcolor;
+        projbuffer[18] = plotreverse;
+        projbuffer[19] = plotunderline;
+        projbuffer[20] = plotblink;
+        projbuffer[21] = plotaltchar;
+        projbuffer[22] = monochrome;
+        projbuffer[23] = VDC_fillattribute;
+	    cbm_k_setlfs(0, targetdevice, 0);
+        sprintf(buffer,"%s.proj",filename);
+	    cbm_k_setnam(buffer);
+	    error = cbm_k_save((unsigned int)projbuffer,(unsigned int)projbuffer+24);
+        if(error) { fileerrormessage(error,0); }
+
+        // Store screen data
+        sprintf(buffer,"%s.scrn",filename);
+        error = screenmap_savefile(buffer);
+        if(error) { fileerrormessage(error,0); }
+        SetLoadSaveBank(1);
+
+        // Store standard charset
+        if(charsetchanged[0]==1)
+        {
+            cbm_k_setlfs(0, targetdevice, 0);
+            sprintf(buffer,"%s.chrs",filename);
+	        cbm_k_setnam(buffer);
+	        error = cbm_k_save(CHARSETNORMAL,CHARSETNORMAL+256*8);
+            if(error) { fileerrormessage(error,0); }
+        }
+
+        // Store alternate charset
+        if(charsetchanged[1]==1)
+        {
+            cbm_k_setlfs(0, targetdevice, 0);
+            sprintf(buffer,"%s.chra",filename);
+	        cbm_k_setnam(buffer);
+	        error = cbm_k_save(CHARSETALTERNATE,CHARSETALTERNATE+256*8);
+            if(error) { fileerrormessage(error,0); }
+        }
+    
+	    // Restore I/O bank to 0
+	    SetLoadSaveBank(0);        
+    }
+}
+
+void loadproject()
+{
+    // Function to load project (screen, charsets and metadata)
+
+    unsigned int lastreadaddress, newwidth, newheight;
+    unsigned char projbuffer[24];
+    unsigned char newmonochrome = 0;
+    unsigned char oldfillattribute = VDC_fillattribute;
+    int escapeflag;
+  
+    escapeflag = chooseidandfilename("Load project",10);
+
+    windowrestore(0);
+
+    if(escapeflag==-1) { return; }
+
+    // Load project variables
+    sprintf(buffer,"%s.proj",filename);
+	cbm_k_setlfs(0,targetdevice, 0);
+	cbm_k_setnam(buffer);
+	SetLoadSaveBank(0);
+	lastreadaddress = cbm_k_load(0,(unsigned int)projbuffer);
+    if(lastreadaddress<=(unsigned int)projbuffer) { return; }
+    charsetchanged[0]       = projbuffer[ 0];
+    charsetchanged[1]       = projbuffer[ 1];
+    screen_col              = projbuffer[ 2];
+    screen_row              = projbuffer[ 3];
+    newwidth                = projbuffer[ 4]*256+projbuffer[ 5];
+    newheight               = projbuffer[ 6]*256+projbuffer [7];
+    screenbackground        = projbuffer[10];
+    VDC_BackColor(screenbackground);
+    sprintf(buffer,"Color: %2i",screenbackground);
+    mc_mb_normal            = projbuffer[11];
+    mc_mb_select            = projbuffer[12];
+    mc_pd_normal            = projbuffer[13];
+    mc_pd_select            = projbuffer[14];
+    mc_menupopup            = projbuffer[15];
+    plotscreencode          = projbuffer[16];
+    plotcolor               = projbuffer[17];
+    plotreverse             = projbuffer[18];
+    plotunderline           = projbuffer[19];
+    plotblink               = projbuffer[20];
+    plotaltchar             = projbuffer[21];
+
+    // Monochrome flag and canvas attribute, absent in projects saved by older versions
+    if(lastreadaddress >= (unsigned int)projbuffer+24)
+    {
+        newmonochrome       = projbuffer[22];
+        VDC_fillattribute   = projbuffer[23];
+    }
+
+    // Load screen, the mode is only switched on a successful load
+    sprintf(buffer,"%s.scrn",filename);
+    if(screenmap_loadfile(buffer,newwidth,newheight,newmonochrome))
+    {
+        sprintf(pulldownmenutitles[0][0],"Width:   %5i ",screenwidth);
+        sprintf(pulldownmenutitles[0][1],"Height:  %5i ",screenheight);
+        sprintf(pulldownmenutitles[0][5],"Mono:      %s",(monochrome==1)? "On ":"Off");
+    }
+    else
+    {
+        // Keep attribute of the present map, redraw as a present map in VDC memory may have been cleared
+        VDC_fillattribute = oldfillattribute;
+    }
+    windowrestore(0);
+    viewportrefresh();
+    windowsave(0,1,0);
+    menuplacebar();
+    if(showbar) { initstatusbar(); }
+    canvas_configure();
+
+    // Load standard charset
+    if(charsetchanged[0]==1)
+    {
+        sprintf(buffer,"%s.chrs",filename);
+        VDC_LoadCharset(buffer,targetdevice,CHARSETNORMAL,1,1);
+    }
+
+    // Load standard charset
+    if(charsetchanged[1]==1)
+    {
+        sprintf(buffer,"%s.chra",filename);
+        VDC_LoadCharset(buffer,targetdevice,CHARSETALTERNATE,1,2);
+    }
+}
+
+void loadcharset(unsigned char stdoralt)
+{
+    // Function to load charset
+    // Input: stdoralt: standard charset (0) or alternate charset (1)
+
+    unsigned int lastreadaddress, charsetaddress;
+    int escapeflag;
+  
+    escapeflag = chooseidandfilename("Load character set",15);
+
+    windowrestore(0);
+
+    if(escapeflag==-1) { return; }
+
+    charsetaddress = (stdoralt==0)? CHARSETNORMAL : CHARSETALTERNATE;
+
+    lastreadaddress = VDC_LoadCharset(filename,targetdevice,charsetaddress,1,0);
+
+    if(lastreadaddress>charsetaddress)
+    {
+        if(stdoralt==0)
+        {
+            VDC_RedefineCharset(charsetaddress,1,VDCCHARSTD,255);
+        }
+        charsetchanged[stdoralt]=1;
+    }
+}
+
+void savecharset(unsigned char stdoralt)
+{
+    // Function to save charset
+    // Input: stdoralt: standard charset (0) or alternate charset (1)
+
+    unsigned char error;
+    unsigned int charsetaddress;
+    int escapeflag;
+  
+    escapeflag = chooseidandfilename("Save character set",15);
+
+    windowrestore(0);
+
+    if(escapeflag==-1) { return; }
+
+    charsetaddress = (stdoralt==0)? CHARSETNORMAL : CHARSETALTERNATE;
+
+    if(checkiffileexists(filename,targetdevice)==1)
+    {
+        // Scratch old file
+        sprintf(buffer,"s:%s",filename);
+        cmd(targetdevice,buffer);
+
+        // Set device ID
+	    cbm_k_setlfs(0, targetdevice, 0);
+
+	    // Set filename
+	    cbm_k_setnam(filename);
+
+	    // Set bank
+	    SetLoadSaveBank(1);
+    
+	    // Load from file to memory
+	    error = cbm_k_save(charsetaddress,charsetaddress+256*8);
+
+	    // Restore I/O bank to 0
+	    SetLoadSaveBank(0);
+
+        if(error) { fileerrormessage(error,0); }
+    }
+}
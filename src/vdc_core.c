@@ -41,6 +41,24 @@
 
 unsigned char vdctoconiocol[16] = {0,12,6,14,5,13,11,3,2,10,8,4,9,7,15,1};
 unsigned char bankconfig[4] = {MMU_BANK0,MMU_BANK1,MMU_BANK2,MMU_BANK3};
+unsigned int VDC_displaybase = VDCBASETEXT;
+unsigned int VDC_rowaddress[25] = {
+	0,80,160,240,320,400,480,560,640,720,800,880,960,
+	1040,1120,1200,1280,1360,1440,1520,1600,1680,1760,1840,1920 };
+unsigned char VDC_cmdlist[VDC_CMDLISTSIZE];
+unsigned int VDC_cmdlength = 0;
+struct VDC_RefreshJob VDC_refreshqueue[VDC_REFRESHJOBS];
+unsigned char VDC_refreshjobs = 0;
+unsigned char VDC_fillattribute = VDC_WHITE;
+unsigned char VDC_refreshframes = 0;
+struct VDC_MemRegion VDC_memregion[VDC_MEMREGIONS];
+unsigned char VDC_memregions = 0;
+unsigned char VDC_memfixed = 0;
+unsigned int VDC_memnext = VDCEXTENDED;
+unsigned int VDC_memfree = 0;
+unsigned int VDC_memtotal = 0;
+unsigned char VDC_rowbuffer[VDC_ROWBUFFER];
+unsigned char REU_value;
 
 unsigned char VDC_ReadRegister(unsigned char registeraddress)
 {
@@ -65,17 +83,6 @@ void VDC_WriteRegister(unsigned char registeraddress, unsigned char registervalu
 	VDC_WriteRegister_core();
 }
 
-void VDC_Poke(int address,  unsigned char value)
-{
-	// Function to store a value to a VDC address
-	// Innput: VDC address and value to store
-	VDC_addrh = (address>>8) & 0xff;
-	VDC_addrl = address & 0xff;
-	VDC_value = value;
-
-	VDC_Poke_core();
-}
-
 unsigned char VDC_Peek(int address)
 {
 	// Function to read a value from a VDC address
@@ -99,6 +106,65 @@ unsigned char VDC_DetectVDCMemSize()
 	return VDC_value;
 }
 
+void VDC_MemAddRegion(char* name, unsigned int address, unsigned int size)
+{
+	// Function to register a named region in the VDC memory region table
+
+	VDC_memregion[VDC_memregions].name = name;
+	VDC_memregion[VDC_memregions].address = address;
+	VDC_memregion[VDC_memregions].size = size;
+	VDC_memregions++;
+}
+
+void VDC_MemInit(unsigned char memorysize)
+{
+	// Function to initialise the VDC memory allocator
+	// Registers the regions fixed by the VDC register setup and makes the rest available
+	// Input: memorysize 16 or 64 as returned by VDC_DetectVDCMemSize
+
+	VDC_memregions = 0;
+	VDC_MemAddRegion("Screen",VDCBASETEXT,0x1000);
+	VDC_MemAddRegion("Swap",VDCSWAPTEXT,0x1000);
+	VDC_MemAddRegion("Charstd",VDCCHARSTD,0x1000);
+	VDC_MemAddRegion("Charalt",VDCCHARALT,0x1000);
+	VDC_memfixed = VDC_memregions;
+	VDC_memtotal = (memorysize==64)? 0xC000 : 0;
+	VDC_MemReset();
+}
+
+void VDC_MemReset()
+{
+	// Function to release all allocated regions, keeping the fixed regions
+
+	VDC_memregions = VDC_memfixed;
+	VDC_memnext = VDCEXTENDED;
+	VDC_memfree = VDC_memtotal;
+}
+
+unsigned int VDC_MemAlloc(char* name, unsigned int size)
+{
+	// Function to allocate a named region in VDC memory
+	// Input: name of region, size in bytes
+	// Output: VDC address of region, or 0 if not enough memory is free
+
+	unsigned int address = VDC_memnext;
+
+	if(!size || size > VDC_memfree || VDC_memregions == VDC_MEMREGIONS) { return 0; }
+
+	VDC_MemAddRegion(name,address,size);
+	VDC_memnext += size;
+	VDC_memfree -= size;
+	return address;
+}
+
+unsigned int VDC_MemAllocRest(char* name)
+{
+	// Function to allocate all remaining free VDC memory as one named region
+	// Output: VDC address of region, or 0 if no memory is free
+
+	return VDC_MemAlloc(name,VDC_memfree);
+}
+
 void VDC_MemCopy(unsigned int sourceaddr, unsigned int destaddr, unsigned int length)
 {
 	// Function to copy memory from one to another position within VDC memory
@@ -108,12 +174,98 @@ void VDC_MemCopy(unsigned int sourceaddr, unsigned int destaddr, unsigned int le
 	VDC_addrl = sourceaddr & 0xff;			// Obtain low byte of source address
 	VDC_desth = (destaddr>>8) & 0xff;		// Obtain high byte of destination address
 	VDC_destl = destaddr & 0xff;			// Obtain low byte of destination address
-	VDC_tmp1 = ((length>>8) & 0xff) + 1;	// Obtain number of 256 byte pages to copy
+	VDC_tmp1 = (length>>8) & 0xff;			// Obtain number of full 256 byte pages to copy
 	VDC_tmp2 = length & 0xff;				// Obtain length in last page to copy
 
 	VDC_MemCopy_core();
 }
 
+void VDC_MemMove(unsigned int sourceaddr, unsigned int destaddr, unsigned int length)
+{
+	// Function to copy memory within VDC memory where source and destination may overlap
+	// The VDC only copies upwards, so a destination just above the source is copied
+	// from the end in parts no longer than the distance between them
+	// Input: Sourceaddress, destination address, number of bytes to copy
+
+	unsigned int distance = destaddr - sourceaddr;
+	unsigned int part;
+
+	if(!length || destaddr == sourceaddr) { return; }
+
+	if(destaddr < sourceaddr || distance >= length)
+	{
+		VDC_MemCopy(sourceaddr,destaddr,length);
+		return;
+	}
+
+	while(length)
+	{
+		part = (length > distance)? distance : length;
+		length -= part;
+		VDC_MemCopy(sourceaddr+length,destaddr+length,part);
+	}
+}
+
+void VDC_RectCopy(unsigned int source, unsigned int sourcepitch, unsigned int dest, unsigned int destpitch, unsigned int width, unsigned int height)
+{
+	// Function to copy a rectangle within VDC memory, with the same overlap rules as BankRectCopy
+	// Input: Source address and pitch, destination address and pitch, width in bytes and height in rows
+
+	if(dest > source || (dest == source && destpitch > sourcepitch))
+	{
+		source += (height-1)*sourcepitch;
+		dest += (height-1)*destpitch;
+		while(height--)
+		{
+			VDC_MemMove(source,dest,width);
+			source -= sourcepitch;
+			dest -= destpitch;
+		}
+		return;
+	}
+
+	while(height--)
+	{
+		VDC_MemMove(source,dest,width);
+		source += sourcepitch;
+		dest += destpitch;
+	}
+}
+
+void VDC_RectSet(unsigned int address, unsigned int pitch, unsigned char value, unsigned int width, unsigned int height)
+{
+	// Function to set a rectangle in VDC memory to given value with one hardware fill per row
+	// Input: Address of first row and pitch, value to set, width in bytes and height in rows
+
+	while(height--)
+	{
+		VDC_FillBlock(address,value,width);
+		address += pitch;
+	}
+}
+
+void VDC_RectTransform(unsigned int address, unsigned int pitch, unsigned int width, unsigned int height)
+{
+	// Function to translate the bytes of a rectangle in VDC memory via the table in VDC_stagebuffer
+	// Rows are read, translated and written back in parts of VDC_ROWBUFFER bytes
+	// Input: Address of first row and pitch, width in bytes and height in rows
+
+	unsigned int done;
+	unsigned char part, x;
+
+	while(height--)
+	{
+		for(done=0;done<width;done+=part)
+		{
+			part = (width-done > VDC_ROWBUFFER)? VDC_ROWBUFFER : width-done;
+			VDC_CopyVDCToMem(address+done,(unsigned int)VDC_rowbuffer,0,part);
+			for(x=0;x<part;x++) { VDC_rowbuffer[x] = VDC_stagebuffer[VDC_rowbuffer[x]]; }
+			VDC_CopyMemToVDC(address+done,(unsigned int)VDC_rowbuffer,0,part);
+		}
+		address += pitch;
+	}
+}
+
 void VDC_HChar(unsigned char row, unsigned char col, unsigned char character, unsigned char length, unsigned char attribute)
 {
 	// Function to draw horizontal line with given character (draws from left to right)
@@ -150,6 +302,9 @@ void VDC_CopyMemToVDC(unsigned int vdcAddress, unsigned int memAddress, unsigned
 {
 	// Function to copy memory from VDC memory to standard memory
 	// Input: Source VDC address, destination standard memory address and bank, number of bytes to copy
+	// Bank VDC_BANKVDC copies within VDC memory
+
+	if(memBank == VDC_BANKVDC) { VDC_MemMove(memAddress,vdcAddress,length); return; }
 
 	length--;
 
@@ -168,6 +323,9 @@ void VDC_CopyVDCToMem(unsigned int vdcAddress, unsigned int memAddress, unsigned
 {
 	// Function to copy memory from VDC memory to standard memory
 	// Input: Source VDC address, destination standard memory address and bank, number of bytes to copy
+	// Bank VDC_BANKVDC copies within VDC memory
+
+	if(memBank == VDC_BANKVDC) { VDC_MemMove(vdcAddress,memAddress,length); return; }
 
 	length--;
 
@@ -208,6 +366,15 @@ void VDC_FillArea(unsigned char row, unsigned char col, unsigned char character,
 	//		  length and height in number of character positions, attribute color value
 
 	unsigned int startaddress = VDC_RowColToAddress(row,col);
+
+	// Full width area is contiguous in VDC memory: fill both planes as one block
+	if(length == VDC_linestride)
+	{
+		VDC_FillBlock(startaddress,character,length*height);
+		VDC_FillBlock(startaddress+VDC_attroffset,attribute,length*height);
+		return;
+	}
+
 	VDC_addrh = (startaddress>>8) & 0xff;	// Obtain high byte of start address
 	VDC_addrl = startaddress & 0xff;		// Obtain low byte of start address
 	VDC_tmp1 = character;					// Obtain character value
@@ -218,6 +385,22 @@ void VDC_FillArea(unsigned char row, unsigned char col, unsigned char character,
 	VDC_FillArea_core();
 }
 
+void VDC_FillBlock(unsigned int address, unsigned char value, unsigned int length)
+{
+	// Function to fill a contiguous block of VDC memory with chained hardware fills
+	// Input: VDC start address, value to fill with, length in bytes
+
+	length--;									// First byte is written via the data register
+
+	VDC_addrh = (address>>8) & 0xff;			// Obtain high byte of start address
+	VDC_addrl = address & 0xff;					// Obtain low byte of start address
+	VDC_value = value;							// Obtain fill value
+	VDC_tmp1 = (length>>8) & 0xff;				// Obtain number of full 256 byte fills
+	VDC_tmp2 = length & 0xff;					// Obtain length of last fill
+
+	VDC_FillBlock_core();
+}
+
 void VDC_Init(void)
 {
 	unsigned int r = 0;
@@ -265,49 +448,58 @@ void VDC_Exit(void)
 	POKE(0xd011,PEEK(0xd011)|(1<<4));		// Enable the 5th bit of the SCROLY register to blank VIC screen
 	POKE(0xd011,PEEK(0xd011)&(~(1<<7)));	// Disable the 8th bit of the SCROLY register to avoid accidentally setting raster interrupt to high
 	POKE(0xd506,0x04);						// Set proper bits in $D506 MMU register for default shared memory
+	VDC_SetDisplay(VDCBASETEXT,VDCBASEATTR,80);	// Point display back to standard screen
 	clrscr();
 }
 
-unsigned char VDC_PetsciiToScreenCode(unsigned char p)
+unsigned int VDC_RowColToAddress(unsigned char row, unsigned char col)
 {
-	/* Convert Petscii values to screen code values */
-	if(p <32)	p = p + 128;
-	else if (p > 63  && p < 96 ) p = p - 64;
-	else if (p > 95  && p < 128) p = p - 32;
-	else if (p > 127 && p < 160) p = p + 64;
-	else if (p > 159 && p < 192) p = p - 64;
-	else if (p > 191 && p < 255) p = p - 128;
-	else if (p == 255) p = 94;
-	
-	return p;
+	/* Function returns a VDC memory address for a given row and column */
+
+	if (row < 25 && col < 80)
+		return VDC_ROWCOLADDRESS(row,col);
+	else
+		return -1;
 }
 
-unsigned char VDC_PetsciiToScreenCodeRvs(unsigned char p)
+void VDC_SetDisplay(unsigned int textaddress, unsigned int attraddress, unsigned int linestride)
 {
-	/* Convert Petscii values to screen code values */
-	if(p <32)	p = p + 128;
-	else if (p > 31  && p < 64 ) p = p + 128;
-	else if (p > 63  && p < 96 ) p = p + 64;
-	else if (p > 95  && p < 128) p = p + 96;
-	else if (p > 127 && p < 160) p = p -128;
-	else if (p > 159 && p < 192) p = p + 64;
-	else if (p > 191 && p < 255) p = p;
-	else if (p == 255) p = 94;
+	// Function to set start of displayed screen and attributes in VDC memory
+	// Input:	textaddress = VDC address of upper left character
+	//			attraddress = VDC address of upper left attribute
+	//			linestride = characters per line in VDC memory (80 to 335)
+
+	unsigned char row;
+
+	VDC_WriteRegister(12,(textaddress>>8) & 0xff);		// Display start address high byte
+	VDC_WriteRegister(13,textaddress & 0xff);			// Display start address low byte
+	VDC_WriteRegister(20,(attraddress>>8) & 0xff);		// Attribute start address high byte
+	VDC_WriteRegister(21,attraddress & 0xff);			// Attribute start address low byte
+	VDC_WriteRegister(27,linestride-80);				// Address increment per row
 
-	return p;
+	VDC_displaybase = textaddress;
+	VDC_attroffset = attraddress - textaddress;
+	VDC_linestride = linestride;
+
+	// Rebuild row address table
+	for(row=0;row<25;row++)
+	{
+		VDC_rowaddress[row] = textaddress;
+		textaddress += linestride;
+	}
 }
 
-unsigned int VDC_RowColToAddress(unsigned char row, unsigned char col)
+unsigned char VDC_CursorAt(unsigned char row, unsigned char col)
 {
-	/* Function returns a VDC memory address for a given row and column */
+	// Function to place the VDC hardware cursor at specified row and column
 
-	unsigned int addr;
-	addr = row * 80 + col;
+	unsigned int address = VDC_RowColToAddress(row,col);
 
-	if (addr < 2000)
-		return addr;
-	else
-		return -1;
+	if (address == -1) { return 0; }
+
+	VDC_WriteRegister(14,(address>>8) & 0xff);			// Cursor address high byte
+	VDC_WriteRegister(15,address & 0xff);				// Cursor address low byte
+	return 1;
 }
 
 void VDC_BackColor(unsigned char color)
@@ -327,26 +519,15 @@ void VDC_BackColor(unsigned char color)
 unsigned char VDC_PrintAt(unsigned char row, unsigned char col, char *text, unsigned char attribute)
 {
 	// Function to print string at specified row and column start position, in reverse or not
+	// Streams the translated characters in one run and sets the attributes with one hardware fill
 
 	unsigned char x;
-	unsigned int address;
 
-	address = VDC_RowColToAddress(row, col);
+	if (VDC_RowColToAddress(row, col) == -1) { return -1; }
 
-	if (address != -1)
-	{
-		x = 0;
-		while(text[x] != 0)
-		{
-			VDC_Poke(address, VDC_PetsciiToScreenCode(text[x]));
-			VDC_Poke(address+0x800, attribute);
-			address++;
-			x++;
-		}
-		return x;
-	}
-	else
-		return -1;
+	x = VDC_CmdPrintAt(row,col,text,attribute);
+	VDC_CmdRun();
+	return x;
 }
 
 unsigned int VDC_LoadCharset(char* filename, unsigned char deviceid, unsigned int source, unsigned char sourcebank, unsigned char stdoralt)
@@ -438,22 +619,75 @@ unsigned char VDC_SaveScreen(char* filename, unsigned char deviceid, unsigned in
 	return error;
 } 
 
-unsigned char VDC_Attribute(unsigned char textcolor, unsigned char blink, unsigned char underline, unsigned char reverse, unsigned char alternate)
+unsigned int VDC_LoadStream(char* filename, unsigned char deviceid, unsigned int vdcaddress, unsigned int maxlength)
 {
-	// Function to calculate attribute code from color and other attribute bits
-	// Input: Color code 0-15 and flags for blink, underline, reverse and alternate charset
+	// Function to load a program file directly to VDC memory, streamed through the staging buffer
+	// The two byte load address of the file is skipped
+	// Input: filename, device id, VDC destination address, maximum number of bytes to load
+	// Output: VDC address after last byte read (if not higher than start address an error has occurred)
 
-	return textcolor + (blink*16) + (underline*32) + (reverse*64) + (alternate*128);
+	char name[32];
+	unsigned int address = vdcaddress;
+	unsigned int part;
+	int read;
+
+	sprintf(name,"%s,p,r",filename);
+	if(cbm_open(2,deviceid,2,name)) { cbm_close(2); return 0; }
+
+	read = cbm_read(2,VDC_stagebuffer,2);
+	if(read == 2)
+	{
+		while(maxlength)
+		{
+			part = (maxlength > 256)? 256 : maxlength;
+			read = cbm_read(2,VDC_stagebuffer,part);
+			if(read <= 0) { break; }
+			VDC_CopyMemToVDC(address,(unsigned int)VDC_stagebuffer,0,read);
+			address += read;
+			maxlength -= read;
+		}
+	}
+	cbm_close(2);
+
+	return (read < 0)? 0 : address;
 }
 
-void VDC_Plot(unsigned char row, unsigned char col, unsigned char screencode, unsigned char attribute)
+unsigned char VDC_SaveStream(char* filename, unsigned char deviceid, unsigned int vdcaddress, unsigned int length, unsigned int loadaddress)
 {
-	// Function to plot a screencodes at VDC screen
-	// Input: row and column, screencode to plot, attribute code
+	// Function to save VDC memory directly to a program file, streamed through the staging buffer
+	// Input: filename, device id, VDC source address and number of bytes, load address for file header
+	// Output: error code
 
-	unsigned int address = VDC_RowColToAddress(row,col);
-	VDC_Poke(address,screencode);
-	VDC_Poke(address+0x0800,attribute);
+	char name[32];
+	unsigned int part;
+	unsigned char error = 0;
+
+	sprintf(name,"%s,p,w",filename);
+	if(cbm_open(2,deviceid,2,name)) { cbm_close(2); return _oserror; }
+
+	VDC_stagebuffer[0] = loadaddress & 0xff;
+	VDC_stagebuffer[1] = (loadaddress>>8) & 0xff;
+	if(cbm_write(2,VDC_stagebuffer,2) != 2) { error = _oserror; length = 0; }
+
+	while(length)
+	{
+		part = (length > 256)? 256 : length;
+		VDC_CopyVDCToMem(vdcaddress,(unsigned int)VDC_stagebuffer,0,part);
+		if(cbm_write(2,VDC_stagebuffer,part) != part) { error = _oserror; break; }
+		vdcaddress += part;
+		length -= part;
+	}
+	cbm_close(2);
+
+	return error;
+}
+
+unsigned char VDC_Attribute(unsigned char textcolor, unsigned char blink, unsigned char underline, unsigned char reverse, unsigned char alternate)
+{
+	// Function to calculate attribute code from color and other attribute bits
+	// Input: Color code 0-15 and flags for blink, underline, reverse and alternate charset
+
+	return textcolor + (blink*16) + (underline*32) + (reverse*64) + (alternate*128);
 }
 
 void VDC_PlotString(unsigned char row, unsigned char col, char* plotstring, unsigned char length, unsigned char attribute)
@@ -461,22 +695,24 @@ void VDC_PlotString(unsigned char row, unsigned char col, char* plotstring, unsi
 	// Function to plot a string of screencodes at VDC screen, no trailing zero needed
 	// Input: row and column, string to plot, length to plot, attribute code
 	
-	unsigned char x;
+	unsigned int address = VDC_RowColToAddress(row,col);
 
-	for(x=0;x<length;x++)
-	{
-		VDC_Plot(row,col++,plotstring[x],attribute);
-	}
+	if (address == -1 || length == 0) { return; }
+
+	VDC_CmdString(address,(unsigned char*)plotstring,length);
+	VDC_CmdFill(address+VDC_attroffset,attribute,length);
+	VDC_CmdRun();
 }
 
-void VDC_CopyViewPortToVDC(unsigned int sourcebase, unsigned char sourcebank, unsigned int sourcewidth, unsigned int sourceheight, unsigned int sourcexoffset, unsigned int sourceyoffset, unsigned char xcoord, unsigned char ycoord, unsigned char viewwidth, unsigned char viewheight )
+void VDC_CopyViewPortToVDC(unsigned int sourcebase, unsigned char sourcebank, unsigned int sourcepitch, unsigned int sourceattroffset, unsigned int sourcexoffset, unsigned int sourceyoffset, unsigned char xcoord, unsigned char ycoord, unsigned char viewwidth, unsigned char viewheight )
 {
 	// Function to copy a viewport on the source screen map to the VDC
 	// Input:
 	// - Source:	sourcebase			= source base address in memory
-	//				sourcebank			= memory bank of source (0 or 1)
-	//				sourcewidth			= number of characters per line in source screen map
-	//				sourceheight		= number of lines in source screen map
+	//				sourcebank			= memory bank of source (0 or 1, or VDC_BANKVDC for VDC memory)
+	//				sourcepitch			= number of bytes per line in source screen map
+	//				sourceattroffset	= offset of attribute plane from source base address,
+	//									  0 for a map without attributes, filled with VDC_fillattribute
 	//				sourcexoffset		= horizontal offset on source screen map to start upper left corner of viewpoint
 	//				sourceyoffset		= vertical offset on source screen map to start upper left corner of viewpoint
 	// - Viewport:	xcoord				= x coordinate of viewport upper left corner
@@ -485,10 +721,29 @@ void VDC_CopyViewPortToVDC(unsigned int sourcebase, unsigned char sourcebank, un
 	//				viewheight			= height of viewport in number of lines
 
 	// Charachters
-	unsigned int stride = sourcewidth - viewwidth;
-	unsigned int vdcbase = VDCBASETEXT + (ycoord * 80) + xcoord;
+	unsigned int stride = sourcepitch - viewwidth;
+	unsigned int vdcbase = VDC_RowColToAddress(ycoord,xcoord);
 
-	sourcebase += (sourceyoffset * sourcewidth ) + sourcexoffset;
+	sourcebase += (sourceyoffset * sourcepitch ) + sourcexoffset;
+
+	// No attribute plane: hardware fill of the attributes, characters only copied
+	if(!sourceattroffset)
+	{
+		VDC_FillViewPortAttr(vdcbase+VDC_attroffset,viewwidth,viewheight);
+	}
+
+	// Source in VDC memory: one block copy per line and plane
+	if(sourcebank == VDC_BANKVDC)
+	{
+		while(viewheight--)
+		{
+			VDC_MemCopy(sourcebase,vdcbase,viewwidth);
+			if(sourceattroffset) { VDC_MemCopy(sourcebase+sourceattroffset,vdcbase+VDC_attroffset,viewwidth); }
+			sourcebase += sourcepitch;
+			vdcbase += VDC_linestride;
+		}
+		return;
+	}
 
 	VDC_addrh = (sourcebase>>8) & 0xff;					// Obtain high byte of source address
 	VDC_addrl = sourcebase & 0xff;						// Obtain low byte of source address
@@ -503,8 +758,9 @@ void VDC_CopyViewPortToVDC(unsigned int sourcebase, unsigned char sourcebank, un
 	VDC_CopyViewPortToVDC_core();
 
 	// Attributes
-	sourcebase += (sourceheight * sourcewidth) + 48;
-	vdcbase += 0x0800;
+	if(!sourceattroffset) { return; }
+	sourcebase += sourceattroffset;
+	vdcbase += VDC_attroffset;
 
 	VDC_addrh = (sourcebase>>8) & 0xff;					// Obtain high byte of source address
 	VDC_addrl = sourcebase & 0xff;						// Obtain low byte of source address
@@ -516,14 +772,35 @@ void VDC_CopyViewPortToVDC(unsigned int sourcebase, unsigned char sourcebank, un
 	VDC_CopyViewPortToVDC_core();
 }
 
-void VDC_ScrollCopy(unsigned int sourcebase, unsigned char sourcebank, unsigned int sourcewidth, unsigned int sourceheight, unsigned int sourcexoffset, unsigned int sourceyoffset, unsigned char xcoord, unsigned char ycoord, unsigned char viewwidth, unsigned char viewheight, unsigned char direction)
+void VDC_FillViewPortAttr(unsigned int address, unsigned char viewwidth, unsigned char viewheight)
+{
+	// Function to fill the attributes of a viewport with VDC_fillattribute
+	// Input: VDC address of first attribute, width and height of viewport
+
+	if(!viewwidth || !viewheight) { return; }
+	if(viewwidth == VDC_linestride)
+	{
+		VDC_FillBlock(address,VDC_fillattribute,viewwidth*viewheight);
+		return;
+	}
+	while(viewheight--)
+	{
+		// Single column refills from scrolling are plotted, wider rows are filled
+		if(viewwidth == 1) { VDC_CmdPoke(address,VDC_fillattribute); }
+		else { VDC_CmdFill(address,VDC_fillattribute,viewwidth); }
+		address += VDC_linestride;
+	}
+	VDC_CmdRun();
+}
+
+void VDC_ScrollCopy(unsigned int sourcebase, unsigned char sourcebank, unsigned int sourcepitch, unsigned int sourceattroffset, unsigned int sourcexoffset, unsigned int sourceyoffset, unsigned char xcoord, unsigned char ycoord, unsigned char viewwidth, unsigned char viewheight, unsigned char direction)
 {
 	// Function to scroll a viewport on the source screen map on the VDC in the given direction
 	// Input:
 	// - Source:	sourcebase			= source base address in memory
 	//				sourcebank			= memory bank of source (0 or 1)
-	//				sourcewidth			= number of characters per line in source screen map
-	//				sourceheight		= number of lines in source screen map
+	//				sourcepitch			= number of bytes per line in source screen map
+	//				sourceattroffset	= offset of attribute plane from source base address
 	//				sourcexoffset		= horizontal offset on source screen map to start upper left corner of viewpoint
 	//				sourceyoffset		= vertical offset on source screen map to start upper left corner of viewpoint
 	// - Viewport:	xcoord				= x coordinate of viewport upper left corner
@@ -536,97 +813,103 @@ void VDC_ScrollCopy(unsigned int sourcebase, unsigned char sourcebank, unsigned
 	//									  bit 5 set ($04): down
 	//									  bit 4 set ($08): up
 
-	unsigned int sourceaddr = VDCBASETEXT + (ycoord*80) + xcoord;
-	unsigned int destaddr = VDCSWAPTEXT + (ycoord*80) + xcoord;
+	// First scroll the viewport in place
+	VDC_ScrollMove(xcoord,ycoord,viewwidth,viewheight,direction);
 
-	// First copy viewport to swap screen
-	// Characters
-	VDC_addrh = (sourceaddr>>8) & 0xff;		// Obtain high byte of source address
-	VDC_addrl = sourceaddr & 0xff;			// Obtain low byte of source address
-	VDC_desth = (destaddr>>8) & 0xff;		// Obtain high byte of destination address
-	VDC_destl = destaddr & 0xff;			// Obtain low byte of destination address
-	VDC_tmp1 = --viewheight;				// Obtain number of lines to copy
-	VDC_tmp2 = viewwidth;					// Obtain length of lines to copy
-	VDC_ScrollCopy_core();
-
-	// Attributes
-	sourceaddr += 0x0800;
-	destaddr += 0x0800;
-
-	VDC_addrh = (sourceaddr>>8) & 0xff;		// Obtain high byte of source address
-	VDC_addrl = sourceaddr & 0xff;			// Obtain low byte of source address
-	VDC_desth = (destaddr>>8) & 0xff;		// Obtain high byte of destination address
-	VDC_destl = destaddr & 0xff;			// Obtain low byte of destination address
-	VDC_tmp1 = viewheight;					// Obtain number of lines to copy
-	VDC_tmp2 = viewwidth;					// Obtain length of lines to copy
-	VDC_ScrollCopy_core();
-
-	// Then copy back to main screen one position scrolled
-	sourceaddr = VDCSWAPTEXT + (ycoord*80) + xcoord;
-	destaddr = VDCBASETEXT + (ycoord*80) + xcoord;
-
-	if(direction == SCROLL_LEFT) { ++sourceaddr; viewwidth--; }
-	if(direction == SCROLL_RIGHT) { ++destaddr; viewwidth--; }
-	if(direction == SCROLL_DOWN) { destaddr += 80; viewheight--; }
-	if(direction == SCROLL_UP) { sourceaddr += 80; viewheight--; }
-
-	// Characters
-	VDC_addrh = (sourceaddr>>8) & 0xff;		// Obtain high byte of source address
-	VDC_addrl = sourceaddr & 0xff;			// Obtain low byte of source address
-	VDC_desth = (destaddr>>8) & 0xff;		// Obtain high byte of destination address
-	VDC_destl = destaddr & 0xff;			// Obtain low byte of destination address
-	VDC_tmp1 = viewheight;					// Obtain number of 256 byte pages to copy
-	VDC_tmp2 = viewwidth;					// Obtain length in last page to copy
-	VDC_ScrollCopy_core();
-
-	// Attributes
-	sourceaddr += 0x0800;
-	destaddr += 0x0800;
-
-	VDC_addrh = (sourceaddr>>8) & 0xff;		// Obtain high byte of source address
-	VDC_addrl = sourceaddr & 0xff;			// Obtain low byte of source address
-	VDC_desth = (destaddr>>8) & 0xff;		// Obtain high byte of destination address
-	VDC_destl = destaddr & 0xff;			// Obtain low byte of destination address
-	VDC_tmp1 = viewheight;					// Obtain number of 256 byte pages to copy
-	VDC_tmp2 = viewwidth;					// Obtain length in last page to copy
-	VDC_ScrollCopy_core();
-
-	// Finally add the new line or column
+	// Then add the new line or column
 	switch (direction)
 	{
 	case SCROLL_LEFT:
-		sourcexoffset += viewwidth+1;
-		xcoord += viewwidth;
-		viewwidth = 1;
-		viewheight++;
+		VDC_CopyViewPortToVDC(sourcebase,sourcebank,sourcepitch,sourceattroffset,sourcexoffset+viewwidth,sourceyoffset,xcoord+viewwidth-1,ycoord,1,viewheight);
 		break;
 
 	case SCROLL_RIGHT:
-		sourcexoffset--;
-		viewwidth = 1;
-		viewheight++;
+		VDC_CopyViewPortToVDC(sourcebase,sourcebank,sourcepitch,sourceattroffset,sourcexoffset-1,sourceyoffset,xcoord,ycoord,1,viewheight);
 		break;
 
 	case SCROLL_DOWN:
-		sourceyoffset--;
-		viewheight = 1;
+		VDC_CopyViewPortToVDC(sourcebase,sourcebank,sourcepitch,sourceattroffset,sourcexoffset,sourceyoffset-1,xcoord,ycoord,viewwidth,1);
 		break;
 
 	case SCROLL_UP:
-		sourceyoffset += viewheight+2;
-		ycoord += viewheight+1;
-		viewheight = 1;
+		VDC_CopyViewPortToVDC(sourcebase,sourcebank,sourcepitch,sourceattroffset,sourcexoffset,sourceyoffset+viewheight,xcoord,ycoord+viewheight-1,viewwidth,1);
 		break;
 	
 	default:
 		break;
 	}
-	VDC_CopyViewPortToVDC(sourcebase,sourcebank,sourcewidth,sourceheight,sourcexoffset,sourceyoffset,xcoord,ycoord,viewwidth,viewheight);
+}
+
+void VDC_RefreshQueue(unsigned int sourcebase, unsigned char sourcebank, unsigned int sourcepitch, unsigned int sourceattroffset, unsigned int sourcexoffset, unsigned int sourceyoffset, unsigned char xcoord, unsigned char ycoord, unsigned char viewwidth, unsigned char viewheight)
+{
+	// Function to queue a viewport refresh job, same input as VDC_CopyViewPortToVDC
+	// Runs the queue first if it is full
+
+	struct VDC_RefreshJob* job;
+
+	if(VDC_refreshjobs == VDC_REFRESHJOBS) { VDC_RefreshRun(); }
+
+	job = &VDC_refreshqueue[VDC_refreshjobs++];
+	job->sourcebase = sourcebase;
+	job->sourcebank = sourcebank;
+	job->sourcepitch = sourcepitch;
+	job->sourceattroffset = sourceattroffset;
+	job->sourcexoffset = sourcexoffset;
+	job->sourceyoffset = sourceyoffset;
+	job->xcoord = xcoord;
+	job->ycoord = ycoord;
+	job->viewwidth = viewwidth;
+	job->viewheight = viewheight;
+}
+
+void VDC_RefreshRun()
+{
+	// Function to run queued refresh jobs, starting at the start of vertical blank
+	// All jobs then run to the end without waiting, so a refresh taking more than one frame is not slowed down
+	// VDC_refreshframes holds the number of frames that passed during the last run,
+	// measured with the low byte of the jiffy clock, which the kernal raster interrupt counts once per frame
+
+	unsigned char x, start;
+	struct VDC_RefreshJob* job;
+
+	if(!VDC_refreshjobs) { return; }
+
+	VDC_WaitVBlank();
+	start = PEEK(JIFFYCLOCK+2);
+	for(x=0;x<VDC_refreshjobs;x++)
+	{
+		job = &VDC_refreshqueue[x];
+		VDC_CopyViewPortToVDC(job->sourcebase,job->sourcebank,job->sourcepitch,job->sourceattroffset,job->sourcexoffset,job->sourceyoffset,job->xcoord,job->ycoord,job->viewwidth,job->viewheight);
+	}
+	VDC_refreshframes = PEEK(JIFFYCLOCK+2) - start;
+	VDC_refreshjobs = 0;
+}
+
+void VDC_ScrollLines(unsigned int sourceaddr, unsigned int destaddr, unsigned char lines, unsigned char length, int linestep)
+{
+	// Function to block copy a number of lines within VDC memory, line by line
+	// Input: source and destination address of first line, number of lines, length per line
+	//		  and step to next line (80 to copy top to bottom, -80 to copy bottom to top)
+
+	if(lines==0 || length==0) { return; }
+
+	VDC_addrh = (sourceaddr>>8) & 0xff;		// Obtain high byte of source address
+	VDC_addrl = sourceaddr & 0xff;			// Obtain low byte of source address
+	VDC_desth = (destaddr>>8) & 0xff;		// Obtain high byte of destination address
+	VDC_destl = destaddr & 0xff;			// Obtain low byte of destination address
+	VDC_strideh = (linestep>>8) & 0xff;		// Obtain high byte of line step
+	VDC_stridel = linestep & 0xff;			// Obtain low byte of line step
+	VDC_tmp1 = lines - 1;					// Obtain number of lines to copy
+	VDC_tmp2 = length;						// Obtain length of lines to copy
+	VDC_ScrollCopy_core();
 }
 
 void VDC_ScrollMove(unsigned char xcoord, unsigned char ycoord, unsigned char viewwidth, unsigned char viewheight, unsigned char direction)
 {
-	// Function to scroll a viewport without filling in the emptied row or column
+	// Function to scroll a viewport in place without filling in the emptied row or column
+	// Scrolls left and up copy forward, down copies rows bottom to top,
+	// right is staged per row via the swap screen as the VDC only copies forward.
+	// Full width viewports are contiguous in VDC memory and use one chained block copy.
 	// Input:
 	// - Viewport:	xcoord				= x coordinate of viewport upper left corner
 	//				ycoord				= y coordinate of viewport upper left corner
@@ -638,63 +921,195 @@ void VDC_ScrollMove(unsigned char xcoord, unsigned char ycoord, unsigned char vi
 	//									  bit 5 set ($04): down
 	//									  bit 4 set ($08): up
 
-	unsigned int sourceaddr = VDCBASETEXT + (ycoord*80) + xcoord;
-	unsigned int destaddr = VDCSWAPTEXT + (ycoord*80) + xcoord;
+	unsigned int base = VDCBASETEXT + (ycoord*80) + xcoord;
+	unsigned int swap = base + (VDCSWAPTEXT - VDCBASETEXT);
+	unsigned char plane;
 
-	// First copy viewport to swap screen
-	// Characters
-	VDC_addrh = (sourceaddr>>8) & 0xff;		// Obtain high byte of source address
-	VDC_addrl = sourceaddr & 0xff;			// Obtain low byte of source address
-	VDC_desth = (destaddr>>8) & 0xff;		// Obtain high byte of destination address
-	VDC_destl = destaddr & 0xff;			// Obtain low byte of destination address
-	VDC_tmp1 = --viewheight;				// Obtain number of lines to copy
-	VDC_tmp2 = viewwidth;					// Obtain length of lines to copy
-	VDC_ScrollCopy_core();
+	// Characters first, then attributes
+	for(plane=0;plane<2;plane++)
+	{
+		switch (direction)
+		{
+		case SCROLL_LEFT:
+			if(viewwidth==80) { VDC_MemCopy(base+1,base,(viewheight*80)-1); }
+			else { VDC_ScrollLines(base+1,base,viewheight,viewwidth-1,80); }
+			break;
+
+		case SCROLL_RIGHT:
+			if(viewwidth==80)
+			{
+				VDC_MemCopy(base,swap,(viewheight*80)-1);
+				VDC_MemCopy(swap,base+1,(viewheight*80)-1);
+			}
+			else
+			{
+				VDC_ScrollLines(base,swap,viewheight,viewwidth-1,80);
+				VDC_ScrollLines(swap,base+1,viewheight,viewwidth-1,80);
+			}
+			break;
+
+		case SCROLL_DOWN:
+			VDC_ScrollLines(base+((viewheight-2)*80),base+((viewheight-1)*80),viewheight-1,viewwidth,-80);
+			break;
+
+		case SCROLL_UP:
+			if(viewwidth==80) { VDC_MemCopy(base+80,base,(viewheight-1)*80); }
+			else { VDC_ScrollLines(base+80,base,viewheight-1,viewwidth,80); }
+			break;
+
+		default:
+			break;
+		}
+		base += 0x0800;
+		swap += 0x0800;
+	}
+}
 
-	// Attributes
-	sourceaddr += 0x0800;
-	destaddr += 0x0800;
+// Generic bank switching functions
 
-	VDC_addrh = (sourceaddr>>8) & 0xff;		// Obtain high byte of source address
-	VDC_addrl = sourceaddr & 0xff;			// Obtain low byte of source address
-	VDC_desth = (destaddr>>8) & 0xff;		// Obtain high byte of destination address
-	VDC_destl = destaddr & 0xff;			// Obtain low byte of destination address
-	VDC_tmp1 = viewheight;					// Obtain number of lines to copy
-	VDC_tmp2 = viewwidth;					// Obtain length of lines to copy
-	VDC_ScrollCopy_core();
+// VDC command list: queue VDC operations and execute them in one core call
 
-	// Then copy back to main screen one position scrolled
-	sourceaddr = VDCSWAPTEXT + (ycoord*80) + xcoord;
-	destaddr = VDCBASETEXT + (ycoord*80) + xcoord;
+void VDC_CmdRun()
+{
+	// Function to execute the command list and start a new one
 
-	if(direction == SCROLL_LEFT) { ++sourceaddr; viewwidth--; }
-	if(direction == SCROLL_RIGHT) { ++destaddr; viewwidth--; }
-	if(direction == SCROLL_DOWN) { destaddr += 80; viewheight--; }
-	if(direction == SCROLL_UP) { sourceaddr += 80; viewheight--; }
+	if(VDC_cmdlength == 0) { return; }
 
-	// Characters
-	VDC_addrh = (sourceaddr>>8) & 0xff;		// Obtain high byte of source address
-	VDC_addrl = sourceaddr & 0xff;			// Obtain low byte of source address
-	VDC_desth = (destaddr>>8) & 0xff;		// Obtain high byte of destination address
-	VDC_destl = destaddr & 0xff;			// Obtain low byte of destination address
-	VDC_tmp1 = viewheight;					// Obtain number of 256 byte pages to copy
-	VDC_tmp2 = viewwidth;					// Obtain length in last page to copy
-	VDC_ScrollCopy_core();
+	VDC_cmdlist[VDC_cmdlength] = VDC_CMD_END;
+	VDC_addrh = ((unsigned int)VDC_cmdlist>>8) & 0xff;	// Obtain high byte of list address
+	VDC_addrl = (unsigned int)VDC_cmdlist & 0xff;		// Obtain low byte of list address
 
-	// Attributes
-	sourceaddr += 0x0800;
-	destaddr += 0x0800;
+	VDC_RunCommands_core();
+	VDC_cmdlength = 0;
+}
 
-	VDC_addrh = (sourceaddr>>8) & 0xff;		// Obtain high byte of source address
-	VDC_addrl = sourceaddr & 0xff;			// Obtain low byte of source address
-	VDC_desth = (destaddr>>8) & 0xff;		// Obtain high byte of destination address
-	VDC_destl = destaddr & 0xff;			// Obtain low byte of destination address
-	VDC_tmp1 = viewheight;					// Obtain number of 256 byte pages to copy
-	VDC_tmp2 = viewwidth;					// Obtain length in last page to copy
-	VDC_ScrollCopy_core();
+void VDC_CmdRoom(unsigned char length)
+{
+	// Function to execute the list first if a command of given length and end marker does not fit
+
+	if(VDC_cmdlength + length >= VDC_CMDLISTSIZE) { VDC_CmdRun(); }
 }
 
-// Generic bank switching functions
+void VDC_CmdSetReg(unsigned char registeraddress, unsigned char registervalue)
+{
+	// Function to add a register write to the command list
+
+	VDC_CmdRoom(3);
+	VDC_cmdlist[VDC_cmdlength++] = VDC_CMD_SETREG;
+	VDC_cmdlist[VDC_cmdlength++] = registeraddress;
+	VDC_cmdlist[VDC_cmdlength++] = registervalue;
+}
+
+void VDC_CmdAddress(unsigned char command, unsigned int address)
+{
+	// Function to add opcode and VDC address of a command to the command list
+
+	VDC_cmdlist[VDC_cmdlength++] = command;
+	VDC_cmdlist[VDC_cmdlength++] = (address>>8) & 0xff;
+	VDC_cmdlist[VDC_cmdlength++] = address & 0xff;
+}
+
+void VDC_CmdFill(unsigned int address, unsigned char value, unsigned char length)
+{
+	// Function to add a hardware fill of length (1-255) bytes to the command list
+	// A single byte is added as a plot, as a word count of 0 would make the VDC fill 256 more bytes
+
+	if(length < 2)
+	{
+		if(length) { VDC_CmdPoke(address,value); }
+		return;
+	}
+
+	VDC_CmdRoom(5);
+	VDC_CmdAddress(VDC_CMD_FILL,address);
+	VDC_cmdlist[VDC_cmdlength++] = value;
+	VDC_cmdlist[VDC_cmdlength++] = length - 1;
+}
+
+void VDC_CmdPoke(unsigned int address, unsigned char value)
+{
+	// Function to add a single byte write to the command list
+
+	VDC_CmdRoom(4);
+	VDC_CmdAddress(VDC_CMD_PLOT,address);
+	VDC_cmdlist[VDC_cmdlength++] = value;
+}
+
+void VDC_CmdString(unsigned int address, unsigned char* data, unsigned char length)
+{
+	// Function to add a string of length (1-240) bytes to the command list, data is copied in the list
+
+	VDC_CmdRoom(length+4);
+	VDC_CmdAddress(VDC_CMD_STRING,address);
+	VDC_cmdlist[VDC_cmdlength++] = length - 1;
+	memcpy(VDC_cmdlist+VDC_cmdlength,data,length);
+	VDC_cmdlength += length;
+}
+
+void VDC_CmdCopy(unsigned int address, unsigned int memaddress, unsigned char length)
+{
+	// Function to add a copy of length (1-255) bytes from bank 0 memory to the command list
+
+	VDC_CmdRoom(6);
+	VDC_CmdAddress(VDC_CMD_COPY,address);
+	VDC_cmdlist[VDC_cmdlength++] = length - 1;
+	VDC_cmdlist[VDC_cmdlength++] = memaddress & 0xff;
+	VDC_cmdlist[VDC_cmdlength++] = (memaddress>>8) & 0xff;
+}
+
+void VDC_CmdBlockCopy(unsigned int destaddr, unsigned int sourceaddr, unsigned char length)
+{
+	// Function to add a VDC block copy of length (1-255) bytes to the command list
+
+	VDC_CmdRoom(6);
+	VDC_CmdAddress(VDC_CMD_BLOCKCOPY,destaddr);
+	VDC_cmdlist[VDC_cmdlength++] = (sourceaddr>>8) & 0xff;
+	VDC_cmdlist[VDC_cmdlength++] = sourceaddr & 0xff;
+	VDC_cmdlist[VDC_cmdlength++] = length;
+}
+
+void VDC_CmdPlot(unsigned char row, unsigned char col, unsigned char screencode, unsigned char attribute)
+{
+	// Function to add a plot of screencode and attribute at row and column to the command list
+
+	unsigned int address = VDC_RowColToAddress(row,col);
+
+	VDC_CmdPoke(address,screencode);
+	VDC_CmdPoke(address+VDC_attroffset,attribute);
+}
+
+unsigned char VDC_CmdPrintAt(unsigned char row, unsigned char col, char *text, unsigned char attribute)
+{
+	// Function to add printing a PETSCII string at row and column to the command list
+
+	unsigned char length = strlen(text);
+	unsigned int address = VDC_RowColToAddress(row,col);
+
+	if (address == -1 || length == 0) { return 0; }
+
+	VDC_CmdRoom(length+9);
+	VDC_CmdAddress(VDC_CMD_STRING,address);
+	VDC_cmdlist[VDC_cmdlength++] = length - 1;
+	memcpy(VDC_cmdlist+VDC_cmdlength,text,length);
+	VDC_TranslateBuffer(VDC_PetsciiToScreenCodeTable,VDC_cmdlist+VDC_cmdlength,length);
+	VDC_cmdlength += length;
+	VDC_CmdFill(address+VDC_attroffset,attribute,length);
+	return length;
+}
+
+void VDC_CmdFillArea(unsigned char row, unsigned char col, unsigned char character, unsigned char length, unsigned char height, unsigned char attribute)
+{
+	// Function to add filling an area with character and attribute to the command list
+
+	unsigned int address = VDC_RowColToAddress(row,col);
+
+	while(height--)
+	{
+		VDC_CmdFill(address,character,length);
+		VDC_CmdFill(address+VDC_attroffset,attribute,length);
+		address += VDC_linestride;
+	}
+}
 
 void SetLoadSaveBank(unsigned char bank)
 {
@@ -705,67 +1120,166 @@ void SetLoadSaveBank(unsigned char bank)
 	SetLoadSaveBank_core();
 }
 
-void POKEB(unsigned int address, unsigned char destbank, unsigned char value)
+unsigned char REU_Detect()
 {
-	// Function to poke to a memory position in specified bank
-	// Input: address, bank and value to poke
-	// Banknumbers: 0/1 for bank 0 or 1 with IO, 2/3 without I/O
+	// Function to detect a REU and its size
+	// The address registers of a REU keep written values, open I/O space does not.
+	// The bank number is written to the first byte of every bank from high to low, so mirrored
+	// banks of a smaller REU are overwritten by a lower bank and read back wrong.
+	// Output: number of 64KB banks (2, 4 or 8 for 1700, 1764 and 1750), 0 if no REU is present
+
+	unsigned char bank;
+
+	POKE(REU_C128ADDRL,0x55);
+	POKE(REU_REUADDRL,0xaa);
+	if(PEEK(REU_C128ADDRL) != 0x55 || PEEK(REU_REUADDRL) != 0xaa) { return 0; }
+	POKE(REU_C128ADDRL,0xaa);
+	POKE(REU_REUADDRL,0x55);
+	if(PEEK(REU_C128ADDRL) != 0xaa || PEEK(REU_REUADDRL) != 0x55) { return 0; }
+
+	bank = REU_MAXBANKS;
+	do
+	{
+		REU_value = --bank;
+		REU_Transfer(REU_STASH,(unsigned int)&REU_value,0,0,bank,1);
+	} while (bank);
 
-	VDC_addrh = (address>>8) & 0xff;					// Obtain high byte of address
-	VDC_addrl = address & 0xff;							// Obtain low byte of address
-	VDC_tmp3 = bankconfig[destbank];					// Set proper MMU config based on bank 0 or 1 with or without I/O
-	VDC_value = value;									// Store value to POKE 
-	POKEB_core();
+	for(bank=0;bank<REU_MAXBANKS;bank++)
+	{
+		REU_Transfer(REU_FETCH,(unsigned int)&REU_value,0,0,bank,1);
+		if(REU_value != bank) { break; }
+	}
+	return bank;
 }
 
-unsigned char PEEKB(unsigned int address, unsigned char sourcebank)
+void REU_Transfer(unsigned char command, unsigned int address, unsigned char bank, unsigned int reuaddress, unsigned char reubank, unsigned int length)
 {
-	// Function to peek a memory position in specified bank
-	// Input: address, bank
-	// Output: peekd value
-	// Banknumbers: 0/1 for bank 0 or 1 with IO, 2/3 without I/O
-
-	VDC_addrh = (address>>8) & 0xff;					// Obtain high byte of address
-	VDC_addrl = address & 0xff;							// Obtain low byte of address
-	VDC_tmp3 = bankconfig[sourcebank];						// Set proper MMU config based on bank 0 or 1 with or without I/O
-	PEEKB_core();
-	return VDC_value;
+	// Function to transfer memory between C128 and REU by DMA, the CPU is halted until it is done
+	// The REU accesses the RAM bank selected by bit 6 of the RAM configuration register,
+	// so addresses have to be below the I/O area. Shared memory is bank 0 as for the CPU.
+	// Input: REU_STASH or REU_FETCH, C128 address and bank 0 or 1, REU address and bank, length in bytes
+
+	unsigned char ramconfig = PEEK(0xd506);
+
+	POKE(0xd506,(bank)? ramconfig | 0x40 : ramconfig & 0xbf);	// Select RAM bank for DMA
+	POKE(REU_C128ADDRL,address & 0xff);
+	POKE(REU_C128ADDRH,(address>>8) & 0xff);
+	POKE(REU_REUADDRL,reuaddress & 0xff);
+	POKE(REU_REUADDRH,(reuaddress>>8) & 0xff);
+	POKE(REU_REUBANK,reubank);
+	POKE(REU_LENGTHL,length & 0xff);
+	POKE(REU_LENGTHH,(length>>8) & 0xff);
+	POKE(REU_ADDRCONTROL,0);
+	POKE(REU_COMMAND,command);										// Transfer starts at once
+	POKE(0xd506,ramconfig);											// Restore RAM configuration
 }
 
-void BankMemCopy(unsigned int source, unsigned char sourcebank, unsigned int dest, unsigned char destbank, unsigned int length)
+void BankMemSet(unsigned int source, unsigned char sourcebank, unsigned char value, unsigned int length)
 {
-	// Function to copy memory to another place in memory with user defined banks
-	// Input: Source address and bank, destination address and bank, length in bytes to copy
-	// Banknumbers: 0/1 for bank 0 or 1 with IO, 2/3 without I/O
+	// Function to set memory in user defined banks to given value
+	// Input: Source address and bank, value to set, length in bytes
+	// Banknumbers: 0/1 for bank 0 or 1 with IO, 2/3 without I/O, VDC_BANKVDC for VDC memory
+
+	if(sourcebank == VDC_BANKVDC) { VDC_FillBlock(source,value,length); return; }
 
 	length--;
 
 	VDC_addrh = (source>>8) & 0xff;						// Obtain high byte of source address
 	VDC_addrl = source & 0xff;							// Obtain low byte of source address
-	VDC_desth = (dest>>8) & 0xff;						// Obtain high byte of destination address
-	VDC_destl = dest & 0xff;							// Obtain low byte of destination address
+	VDC_value = value;									// Obtain value to set
 	VDC_tmp1 = ((length>>8) & 0xff);					// Obtain number of 256 byte pages to copy
 	VDC_tmp2 = length & 0xff;							// Obtain length in last page to copy
 	VDC_tmp3 = bankconfig[sourcebank];					// Set proper MMU config based on bank 0 or 1 with or without I/O
-	VDC_tmp4 = bankconfig[destbank];					// Set proper MMU config based on bank 0 or 1 with or without I/O
 
-	BankMemCopy_core();
+	BankMemSet_core();
 }
 
-void BankMemSet(unsigned int source, unsigned char sourcebank, unsigned char value, unsigned int length)
+void BankRectCopy(unsigned int source, unsigned int sourcepitch, unsigned int dest, unsigned int destpitch, unsigned char bank, unsigned int width, unsigned int height)
 {
-	// Function to set memory in user defined banks to given value
-	// Input: Source address and bank, value to set, length in bytes
-	// Banknumbers: 0/1 for bank 0 or 1 with IO, 2/3 without I/O
+	// Function to copy a rectangle to another place within a user defined bank
+	// Rows are copied bottom up and right to left if destination is above source, so overlap is safe
+	// With equal start addresses the larger pitch counts as above, as used by in place resizing
+	// Input: Source address and pitch, destination address and pitch, bank, width in bytes and height in rows
 
-	length--;
+	if(!width || !height) { return; }
+
+	if(dest == source && destpitch == sourcepitch) { return; }
+
+	if(bank == VDC_BANKVDC) { VDC_RectCopy(source,sourcepitch,dest,destpitch,width,height); return; }
+
+	VDC_value = 0;
+	if(dest > source || (dest == source && destpitch > sourcepitch))
+	{
+		source += (height-1)*sourcepitch;
+		dest += (height-1)*destpitch;
+		sourcepitch = -sourcepitch;
+		destpitch = -destpitch;
+		VDC_value = 1;
+	}
 
 	VDC_addrh = (source>>8) & 0xff;						// Obtain high byte of source address
 	VDC_addrl = source & 0xff;							// Obtain low byte of source address
+	VDC_desth = (dest>>8) & 0xff;						// Obtain high byte of destination address
+	VDC_destl = dest & 0xff;							// Obtain low byte of destination address
+	VDC_strideh = (sourcepitch>>8) & 0xff;				// Obtain high byte of source pitch
+	VDC_stridel = sourcepitch & 0xff;					// Obtain low byte of source pitch
+	VDC_destpitch = destpitch;							// Set destination pitch
+	VDC_rows = height;									// Set number of rows
+	VDC_tmp2 = width & 0xff;							// Obtain length in last page of row
+	VDC_tmp4 = (width>>8) & 0xff;						// Obtain number of full pages per row
+	VDC_tmp3 = bankconfig[bank];						// Set proper MMU config based on bank 0 or 1 with or without I/O
+
+	BankRectCopy_core();
+}
+
+void BankRectSet(unsigned int address, unsigned int pitch, unsigned char bank, unsigned char value, unsigned int width, unsigned int height)
+{
+	// Function to set a rectangle in a user defined bank to given value
+	// Input: Address of first row and pitch, bank, value to set, width in bytes and height in rows
+
+	if(!width || !height) { return; }
+
+	if(bank == VDC_BANKVDC) { VDC_RectSet(address,pitch,value,width,height); return; }
+
+	VDC_addrh = (address>>8) & 0xff;					// Obtain high byte of address
+	VDC_addrl = address & 0xff;							// Obtain low byte of address
+	VDC_strideh = (pitch>>8) & 0xff;					// Obtain high byte of pitch
+	VDC_stridel = pitch & 0xff;							// Obtain low byte of pitch
 	VDC_value = value;									// Obtain value to set
-	VDC_tmp1 = ((length>>8) & 0xff);					// Obtain number of 256 byte pages to copy
-	VDC_tmp2 = length & 0xff;							// Obtain length in last page to copy
-	VDC_tmp3 = bankconfig[sourcebank];					// Set proper MMU config based on bank 0 or 1 with or without I/O
+	VDC_rows = height;									// Set number of rows
+	VDC_tmp2 = width & 0xff;							// Obtain length in last page of row
+	VDC_tmp4 = (width>>8) & 0xff;						// Obtain number of full pages per row
+	VDC_tmp3 = bankconfig[bank];						// Set proper MMU config based on bank 0 or 1 with or without I/O
 
-	BankMemSet_core();
+	BankRectSet_core();
+}
+
+void BankRectTransform(unsigned int address, unsigned int pitch, unsigned char bank, unsigned int width, unsigned int height, unsigned char andmask, unsigned char ormask, unsigned char xormask, const unsigned char* lut)
+{
+	// Function to transform the bytes in a rectangle as new = ((lut[old] & andmask) | ormask) ^ xormask
+	// The combined table is built in the shared staging buffer, so the kernel only needs one lookup per byte
+	// Input: Address of first row and pitch, bank, width in bytes and height in rows, masks and
+	//        lookup table (NULL for none, can be VDC_stagebuffer itself)
+
+	unsigned char x = 0;
+
+	if(!width || !height) { return; }
+
+	do
+	{
+		VDC_stagebuffer[x] = ((((lut)? lut[x] : x) & andmask) | ormask) ^ xormask;
+	} while (++x);
+
+	if(bank == VDC_BANKVDC) { VDC_RectTransform(address,pitch,width,height); return; }
+
+	VDC_addrh = (address>>8) & 0xff;					// Obtain high byte of address
+	VDC_addrl = address & 0xff;							// Obtain low byte of address
+	VDC_strideh = (pitch>>8) & 0xff;					// Obtain high byte of pitch
+	VDC_stridel = pitch & 0xff;							// Obtain low byte of pitch
+	VDC_rows = height;									// Set number of rows
+	VDC_tmp2 = width & 0xff;							// Obtain length in last page of row
+	VDC_tmp4 = (width>>8) & 0xff;						// Obtain number of full pages per row
+	VDC_tmp3 = bankconfig[bank];						// Set proper MMU config based on bank 0 or 1 with or without I/O
+
+	BankRectTransform_core();
 }
\ No newline at end of file
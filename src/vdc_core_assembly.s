@@ -28,7 +28,8 @@
 
     .export		_VDC_ReadRegister_core
 	.export		_VDC_WriteRegister_core
-	.export		_VDC_Poke_core
+	.export		_VDC_Poke
+	.export		_VDC_Plot
 	.export		_VDC_Peek_core
 	.export		_VDC_DetectVDCMemSize_core
 	.export		_VDC_SetExtendedVDCMemSize
@@ -43,10 +44,23 @@
 	.export		_VDC_CopyViewPortToVDC_core
 	.export		_VDC_ScrollCopy_core
 	.export		_SetLoadSaveBank_core
-	.export		_POKEB_core
-	.export		_PEEKB_core
+	.export		_POKEB
+	.export		_PEEKB
+	.export		_BankMemCopy
 	.export		_BankMemCopy_core
 	.export		_BankMemSet_core
+	.export		_BankRectCopy_core
+	.export		_BankRectSet_core
+	.export		_BankRectTransform_core
+	.export		_VDC_stagebuffer
+	.export		_VDC_RunCommands_core
+	.export		_VDC_WaitVBlank
+	.export		_VDC_FillBlock_core
+	.export		_VDC_PetsciiToScreenCode
+	.export		_VDC_PetsciiToScreenCodeRvs
+	.export		_VDC_TranslateBuffer
+	.export		_VDC_PetsciiToScreenCodeTable
+	.export		_VDC_PetsciiToScreenCodeRvsTable
     .export		_VDC_regadd
 	.export		_VDC_regval
 	.export		_VDC_addrh
@@ -60,6 +74,14 @@
 	.export		_VDC_tmp2
 	.export		_VDC_tmp3
 	.export		_VDC_tmp4
+	.export		_VDC_attroffset
+	.export		_VDC_linestride
+	.export		_VDC_destpitch
+	.export		_VDC_rows
+
+	.import		popa, popax
+	.import		_bankconfig
+	.import		_VDC_rowaddress
 
 VDC_ADDRESS_REGISTER    = $D600
 VDC_DATA_REGISTER       = $D601
@@ -92,6 +114,14 @@ _VDC_tmp3:
 	.res	1
 _VDC_tmp4:
 	.res	1
+_VDC_attroffset:
+	.word	$0800
+_VDC_linestride:
+	.word	$0050
+_VDC_destpitch:
+	.res	2
+_VDC_rows:
+	.res	2
 ZPtmp1:
 	.res	1
 ZPtmp2:
@@ -102,6 +132,10 @@ ZPtmp4:
 	.res	1
 MemConfTmp:
 	.res	1
+BankStageLast:
+	.res	1
+_VDC_stagebuffer:						; Page staging buffer and lookup table, in shared low RAM
+	.res	256
 
 ; Generic helper routines
 
@@ -133,6 +167,100 @@ notyetreadywrite:						; Start of wait loop to wait for VDC status ready
 	sta VDC_DATA_REGISTER               ; Store A to VDC data
 	rts
 
+; ------------------------------------------------------------------------------------------
+VDC_WriteStream:
+; Function to stream bytes from memory to the VDC data register
+; Selects register 31 once and relies on VDC address auto increment
+; Input:	$fb/$fc		= source pointer (MMU config already set)
+;			X			= number of full 256 byte pages to copy
+;			VDC_tmp2	= index of last byte to copy in final page
+;			VDC RAM address registers 18/19 already set to destination
+; Output:	$fc			= increased with number of full pages copied
+; ------------------------------------------------------------------------------------------
+
+	lda #$1f							; Load $1f for register 31 (VDC data)
+	sta VDC_ADDRESS_REGISTER			; Select data register once for whole stream
+	ldy #$00							; Set Y as index on 0
+	cpx #$00							; Check if full pages are to be copied
+	beq streamlastpage					; Skip to last page if not
+streampageloop:							; Start of full page loop, unrolled two bytes per pass
+	lda ($fb),y							; Load source data
+streamwait1:							; Start of wait loop to wait for VDC status ready
+	bit VDC_ADDRESS_REGISTER			; Check status bit 7 of VDC address register
+	bpl streamwait1						; Continue loop if status is not ready
+	sta VDC_DATA_REGISTER				; Store A to VDC data
+	iny									; Increase index
+	lda ($fb),y							; Load source data
+streamwait2:							; Start of wait loop to wait for VDC status ready
+	bit VDC_ADDRESS_REGISTER			; Check status bit 7 of VDC address register
+	bpl streamwait2						; Continue loop if status is not ready
+	sta VDC_DATA_REGISTER				; Store A to VDC data
+	iny									; Increase index
+	bne streampageloop					; Continue until page is complete
+	inc $fc								; Increase high byte of source pointer
+	dex									; Decrease page counter
+	bne streampageloop					; Continue until all full pages are copied
+streamlastpage:							; Start of copy loop for last page
+	lda ($fb),y							; Load source data
+streamwait3:							; Start of wait loop to wait for VDC status ready
+	bit VDC_ADDRESS_REGISTER			; Check status bit 7 of VDC address register
+	bpl streamwait3						; Continue loop if status is not ready
+	sta VDC_DATA_REGISTER				; Store A to VDC data
+	cpy _VDC_tmp2						; Check if last byte is reached
+	beq streamend						; Exit if last byte is copied
+	iny									; Increase index
+	bne streamlastpage					; Continue loop (always taken)
+streamend:								; End of stream
+	rts
+
+; ------------------------------------------------------------------------------------------
+VDC_ReadStream:
+; Function to stream bytes from the VDC data register to memory
+; The VDC latches the byte at the update address as soon as register 19 is written
+; and every read of register 31 returns the latched byte, increments the address
+; and prefetches the next byte. So the first read after setting the address is
+; valid and no extra address writes are needed while streaming. The prefetch
+; status is covered by polling the ready bit before every read.
+; Input:	$fb/$fc		= destination pointer (MMU config already set)
+;			X			= number of full 256 byte pages to copy
+;			VDC_tmp2	= index of last byte to copy in final page
+;			VDC RAM address registers 18/19 freshly set to source
+; Output:	$fc			= increased with number of full pages copied
+; ------------------------------------------------------------------------------------------
+
+	lda #$1f							; Load $1f for register 31 (VDC data)
+	sta VDC_ADDRESS_REGISTER			; Select data register once for whole stream
+	ldy #$00							; Set Y as index on 0
+	cpx #$00							; Check if full pages are to be copied
+	beq readlastpage					; Skip to last page if not
+readpageloop:							; Start of full page loop, unrolled two bytes per pass
+	bit VDC_ADDRESS_REGISTER			; Check status bit 7 of VDC address register
+	bpl readpageloop					; Continue loop if status is not ready
+	lda VDC_DATA_REGISTER				; Load data from VDC data register
+	sta ($fb),y							; Store in target memory
+	iny									; Increase index
+readwait2:								; Start of wait loop to wait for VDC status ready
+	bit VDC_ADDRESS_REGISTER			; Check status bit 7 of VDC address register
+	bpl readwait2						; Continue loop if status is not ready
+	lda VDC_DATA_REGISTER				; Load data from VDC data register
+	sta ($fb),y							; Store in target memory
+	iny									; Increase index
+	bne readpageloop					; Continue until page is complete
+	inc $fc								; Increase high byte of destination pointer
+	dex									; Decrease page counter
+	bne readpageloop					; Continue until all full pages are copied
+readlastpage:							; Start of copy loop for last page
+	bit VDC_ADDRESS_REGISTER			; Check status bit 7 of VDC address register
+	bpl readlastpage					; Continue loop if status is not ready
+	lda VDC_DATA_REGISTER				; Load data from VDC data register
+	sta ($fb),y							; Store in target memory
+	cpy _VDC_tmp2						; Check if last byte is reached
+	beq readend							; Exit if last byte is copied
+	iny									; Increase index
+	bne readlastpage					; Continue loop (always taken)
+readend:								; End of stream
+	rts
+
 ; ------------------------------------------------------------------------------------------
 SaveMMUandZP:
 ; Function to safeguard memory configuration and ZP addresses and set selected MMU
@@ -200,25 +328,6 @@ _VDC_WriteRegister_core:
 	jsr VDC_Write						; Write VDC
     rts
 
-; ------------------------------------------------------------------------------------------
-_VDC_Poke_core:
-; Function to store a value to a VDC address
-; Input:	VDC_addrh = VDC address high byte
-;			VDC_addrl = VDC address low byte
-;			VDC_value = value to write
-; ------------------------------------------------------------------------------------------
-
-    ldx #$12                            ; Load $12 for register 18 (VDC RAM address high) in X	
-	lda _VDC_addrh                      ; Load high byte of address in A
-	jsr VDC_Write						; Write VDC
-	inx		    						; Increase X for register 19 (VDC RAM address low)
-	lda _VDC_addrl      				; Load low byte of address in A
-	jsr VDC_Write						; Write VDC
-	ldx #$1f    						; Load $1f for register 31 (VDC data) in X	
-	lda _VDC_value       				; Load value to write in A
-	jsr VDC_Write						; Write VDC
-    rts
-
 ; ------------------------------------------------------------------------------------------
 _VDC_Peek_core:
 ; Function to read a value from a VDC address
@@ -326,23 +435,24 @@ _VDC_CopyCharsetsfromROM:
 ; ------------------------------------------------------------------------------------------
 _VDC_MemCopy_core:
 ; Function to copy memory from one to another position within VDC memory
+; Uses one chained block copy: the VDC continues from the addresses where the
+; previous block ended, so only the word count has to be written per page
 ; Input:	VDC_addrh = high byte of source address
 ;			VDC_addrl = low byte of source address
 ;			VDC_desth = high byte of destination address
 ;			VDC_destl = low byte of destination address
-;			VDC_tmp1 = number of 256 byte pages to copy
+;			VDC_tmp1 = number of full 256 byte pages to copy
 ;			VDC_tmp2 = length in last page to copy
 ; ------------------------------------------------------------------------------------------
 
-loopmemcpy:
 	; Hi-byte of the destination address to register 18
 	ldx #$12    						; Load $12 for register 18 (VDC RAM address high) in X	
 	lda _VDC_desth      				; Load high byte of dest in A
 	jsr VDC_Write						; Write VDC
 
 	; Lo-byte of the destination address to register 19
-	ldx #$13    						; Load $13 for register 19 (VDC RAM address high) in X	
-	lda _VDC_destl       				; Load high byte of dest in A
+	inx 								; Increase X for register 19 (VDC RAM address low)
+	lda _VDC_destl       				; Load low byte of dest in A
 	jsr VDC_Write						; Write VDC
 
 	; Set the copy bit (bit 7) of register 24 (block copy mode)
@@ -356,27 +466,24 @@ loopmemcpy:
 	jsr VDC_Write						; Write VDC
 	
 	; Lo-byte of the source address to block copy source register 33
-	ldx #$21					    	; Load $21 for register 33 (block copy source) in X	
+	inx 								; Increase X for register 33 (block copy source low)
 	lda _VDC_addrl		        		; Load low byte of source in A
 	jsr VDC_Write						; Write VDC
-	
-	; Number of bytes to copy
-	ldx #$1E    						; Load $1E for register 30 (word count) in X
-	lda _VDC_tmp1		        		; Load page counter in A
-	cmp #$01    						; Check if this is the last page
-	bne notyetlastpage			        ; Branch to 'not yet last page' if not equal
-	lda _VDC_tmp2		        		; Set length in last page
-	jmp lastpage		        		; Goto last page label
-notyetlastpage:							; Label for not yet last page
-	lda #$ff    						; Set length for 256 bytes
-lastpage:								; Label for jmp if last page
-	jsr VDC_Write						; Write VDC
-
-	; Decrease page counter and loop until last page
-	inc _VDC_desth		        		; Increase destination address page counter
-	inc _VDC_addrh		        		; Increase source address page counter
-	dec _VDC_tmp1		        		; Decrease page counter
+
+	; Number of bytes to copy, 256 bytes per full page
+	ldx #$1e    						; Load $1E for register 30 (word count) in X
+	ldy _VDC_tmp1						; Load number of full pages in Y
+	beq lastpagememcpy					; Skip if no full pages
+loopmemcpy:								; Start of full page loop
+	lda #$00							; Word count 0 copies 256 bytes
+	jsr VDC_Write						; Write VDC
+	dey									; Decrease page counter
 	bne loopmemcpy				        ; Repeat loop until page counter is zero
+lastpagememcpy:							; Last page
+	lda _VDC_tmp2						; Load length in last page
+	beq endmemcpy						; Skip if nothing left
+	jsr VDC_Write						; Write VDC
+endmemcpy:								; End of routine
     rts
 
 ; ------------------------------------------------------------------------------------------
@@ -387,6 +494,7 @@ _VDC_HChar_core:
 ;			VDC_tmp1 = character value
 ;			VDC_tmp2 = length value
 ;			VDC_tmp3 = attribute value
+;			VDC_attroffset = offset from character to attribute address
 ; ------------------------------------------------------------------------------------------
 
 	; Hi-byte of the destination address to register 18
@@ -416,8 +524,11 @@ _VDC_HChar_core:
 
 	; Continue with copying attribute values
 	clc									; Clear carry
+	lda _VDC_addrl						; Load low byte of start address again in A
+	adc _VDC_attroffset					; Add low byte of attribute offset
+	tay									; Keep low byte of attribute address in Y
 	lda _VDC_addrh						; Load high byte of start address again in A
-	adc #$08							; Add 8 pages to get charachter attribute address
+	adc _VDC_attroffset+1				; Add high byte of attribute offset
 
 	; Hi-byte of the destination attribute address to register 18
 	ldx #$12    						; Load $12 for register 18 (VDC RAM address high) in X	
@@ -425,7 +536,7 @@ _VDC_HChar_core:
 
 	; Lo-byte of the destination attribute address to register 19
 	ldx #$13    						; Load $13 for register 19 (VDC RAM address high) in X	
-	lda _VDC_addrl		        		; Load high byte of start in A
+	tya									; Get low byte of attribute address from Y
 	jsr VDC_Write						; Write VDC
 
 	; Store attribute to write in data register 31
@@ -452,6 +563,8 @@ _VDC_VChar_core:
 ;			VDC_tmp1 = character value
 ;			VDC_tmp2 = length value
 ;			VDC_tmp3 = attribute value
+;			VDC_attroffset = offset from character to attribute address
+;			VDC_linestride = characters per line on screen
 ; ------------------------------------------------------------------------------------------
 
 loopvchar:
@@ -472,8 +585,11 @@ loopvchar:
 
 	; Continue with attribute value
 	clc									; CLear carry
+	lda _VDC_addrl						; Load low byte of start address again in A
+	adc _VDC_attroffset					; Add low byte of attribute offset
+	tay									; Keep low byte of attribute address in Y
 	lda _VDC_addrh						; Load high byte of start address again in A
-	adc #$08							; Add 8 pages to get charachter attribute address
+	adc _VDC_attroffset+1				; Add high byte of attribute offset
 
 	; Hi-byte of the destination attribute address to register 18
 	ldx #$12    						; Load $12 for register 18 (VDC RAM address high) in X	
@@ -481,7 +597,7 @@ loopvchar:
 
 	; Lo-byte of the destination attribute address to register 19
 	ldx #$13    						; Load $13 for register 19 (VDC RAM address high) in X	
-	lda _VDC_addrl			        	; Load high byte of start in A
+	tya									; Get low byte of attribute address from Y
 	jsr VDC_Write						; Write VDC
 
 	; Store attribute to write in data register 31
@@ -489,13 +605,13 @@ loopvchar:
 	lda _VDC_tmp3			        	; Load attribute value in A
 	jsr VDC_Write						; Write VDC
 
-	; Increase start address with 80 for next line
+	; Increase start address with line stride for next line
 	clc 								; Clear carry
 	lda _VDC_addrl	        			; Load low byte of address to A
-	adc #$50    						; Add 80 with carry
+	adc _VDC_linestride					; Add low byte of line stride
 	sta _VDC_addrl			        	; Store result back
 	lda _VDC_addrh	        			; Load high byte of address to A
-	adc #$00    						; Add 0 with carry
+	adc _VDC_linestride+1				; Add high byte of line stride
 	sta _VDC_addrh	        			; Store result back
 
 	; Loop until length reaches zero
@@ -533,28 +649,9 @@ _VDC_CopyMemToVDC_core:
 	lda _VDC_destl      				; Load low byte of address in A
 	jsr VDC_Write						; Write VDC
 
-	; Start of copy loop
-	ldy #$00    						; Set Y as counter on 0
-	
-	; Read value and store at VDC address
-copyloopm2v:							; Start of copy loop
-	lda ($fb),y							; Load source data
-	ldx #$1f    						; Load $1f for register 31 (VDC data) in X
-	jsr VDC_Write						; Write VDC
-
-	; Increase source address (VDC auto increments)
-	inc $fb								; Increment low byte of source address
-	bne nextm2v1						; If not yet zero, branch to next label
-	inc $fc								; Increment high byte of source address
-nextm2v1:								; Next label
-	dec _VDC_tmp2						; Decrease low byte of length
-	lda _VDC_tmp2						; Load low byte of length to A
-	cmp #$ff							; Check if below zero
-	bne copyloopm2v						; Continue loop if not yet below zero
-	dec _VDC_tmp1						; Decrease high byte of length
-	lda _VDC_tmp1						; Load high byte of length to A
-	cmp #$ff							; Check if below zero
-	bne copyloopm2v						; Continue loop if not yet below zero
+	; Stream data to VDC (VDC auto increments)
+	ldx _VDC_tmp1						; Load number of full pages in X
+	jsr VDC_WriteStream					; Stream data to VDC
 
 	jsr RestoreMMUandZP					; Restore MU/ZP
 	rts
@@ -573,18 +670,11 @@ _VDC_CopyVDCToMem_core:
 
 	jsr SaveMMUandZP					; Safeguard MMU/ZP and set MMU
 
-	; Set address pointer in zero-page and STAVEC vector
+	; Set address pointer in zero-page
 	lda _VDC_destl						; Obtain low byte in A
 	sta $fb								; Store low byte in pointer
 	lda _VDC_desth						; Obtain high byte in A
 	sta $fc								; Store high byte in pointer
-	lda #$fb							; Load $fb address value in A
-	sta $2b9							; Save in STAVEC vector
-
-	; Start of copy loop
-	ldy #$00    						; Set Y as counter on 0
-
-copyloopv2m:							; Start of copy loop
 
 	; Hi-byte of the source VDC address to register 18
 	ldx #$12    						; Load $12 for register 18 (VDC RAM address high) in X	
@@ -595,29 +685,10 @@ copyloopv2m:							; Start of copy loop
 	inx 								; Increase X for register 19 (VDC RAM address low)
 	lda _VDC_addrl      				; Load low byte of address in A
 	jsr VDC_Write						; Write VDC
-	
-	; Read VDC value and store at destination address
-	ldx #$1f    						; Load $1f for register 31 (VDC data) in X
-	jsr VDC_Read						; Read VDC
-	sta ($fb),y							; Store in target memory
 
-	; Increase VDC source address and target memory address
-	inc $fb								; Increment low byte of target address
-	bne nextv2m1						; If not yet zero, branch to next label
-	inc $fc								; Increment high byte of target address
-nextv2m1:								; Next label
-	inc _VDC_addrl						; Increment low byte of VDC address
-	bne nextv2m2						; If not yet zero, branch to next label
-	inc _VDC_addrh						; Increment hight byte of VDC address
-nextv2m2:								; Next label
-	dec _VDC_tmp2						; Decrease low byte of length
-	lda _VDC_tmp2						; Load low byte of length to A
-	cmp #$ff							; Check if below zero
-	bne copyloopv2m						; Continue loop if not yet below zero
-	dec _VDC_tmp1						; Decrease high byte of length
-	lda _VDC_tmp1						; Load high byte of length to A
-	cmp #$ff							; Check if below zero
-	bne copyloopv2m						; Continue loop if not yet below zero
+	; Stream data from VDC (VDC auto increments)
+	ldx _VDC_tmp1						; Load number of full pages in X
+	jsr VDC_ReadStream					; Stream data from VDC
 
 	jsr RestoreMMUandZP					; Restore MU/ZP
     rts
@@ -651,57 +722,45 @@ _VDC_RedefineCharset_core:
 	lda _VDC_destl      				; Load low byte of address in A
 	jsr VDC_Write						; Write VDC
 
+	; Select data register once, VDC auto increments
+	lda #$1f							; Load $1f for register 31 (VDC data)
+	sta VDC_ADDRESS_REGISTER			; Select data register for whole stream
+
 	; Start of copy loop
-	ldy #$00    						; Set Y as counter on 0
+	ldy #$00    						; Set Y as index on 0
 looprc1:								; Start of outer loop
-	
-	; Read value from data register
+	ldx #$08							; Set X as counter for 8 bytes per char
+
+	; Copy 8 bytes of character definition
 looprc2:								; Start of 8 bytes character copy loop
 	lda ($fb),y							; Load from source address
-	ldx #$1f    						; Load $1f for register 31 (VDC data) in X
-	jsr VDC_Write						; Write VDC
-
-	; Count 8 bytes per char
-	iny 								; Increase Y counter
-	cpy #$08    						; Is counter at 8?
-	bcc looprc2				        	; If not yet 8, go to start of char copy loop
+waitrc1:								; Start of wait loop to wait for VDC status ready
+	bit VDC_ADDRESS_REGISTER			; Check status bit 7 of VDC address register
+	bpl waitrc1							; Continue loop if status is not ready
+	sta VDC_DATA_REGISTER				; Store A to VDC data
+	iny 								; Increase source index
+	dex									; Decrease byte counter
+	bne looprc2				        	; Continue until 8 bytes are copied
+	tya									; Check if source index wrapped to next page
+	bne nextrc1							; Skip if not
+	inc $fc								; Increase high byte of source address
+nextrc1:								; Next label
 
 	; Add 8 bytes of zero padding per char
 	lda #$00    						; Set 0 value to use as padding in A
+	ldx #$08							; Set X as counter for 8 padding bytes
 looprc3:								; Start of padding loop
-	jsr VDC_Write						; Write VDC
-	dey 								; Decrease Y counter
+	bit VDC_ADDRESS_REGISTER			; Check status bit 7 of VDC address register
+	bpl looprc3							; Continue loop if status is not ready
+	sta VDC_DATA_REGISTER				; Store A to VDC data
+	dex 								; Decrease counter
 	bne looprc3		        			; Continue padding looop if counter is not yet zero
 
 	; Next character
-	clc 								; Clear carry
-	lda $fb		       				 	; Load low byte of source address in A
-	adc #$08    						; Add 8 to address with carry
-	sta $fb		       				 	; Store new address low byte
-	lda $fc      						; Load high byte of source address in A
-	adc #$00    						; Add zero with carry to A
-	sta $fc        						; Store new address high byte
 	dec _VDC_tmp1			        	; Decrease character length counter
-	bne looprc1				        	; Branch for outer loop if not yet zero
-
-	; Copy one final char
-	ldy #$00       						; Set Y as counter on 0
-looprc4:								; Start of 8 bytes character copy loop
-	lda ($fb),y							; Load from source address
-	ldx #$1f    						; Load $1f for register 31 (VDC data) in X
-	jsr VDC_Write						; Write VDC
-
-	; Count 8 bytes per char
-	iny 								; Increase Y counter
-	cpy #$08    						; Is counter at 8?
-	bcc looprc4       					; If not yet 8, go to start of char copy loop
-
-; Add 8 bytes of zero padding per char
-	lda #$00    						; Set 0 value to use as padding in A
-looprc5:								; Start of padding loop
-	jsr VDC_Write						; Write VDC
-	dey 								; Decrease Y counter
-	bne looprc5		        			; Continue padding looop if counter is not yet zero
+	lda _VDC_tmp1						; Load counter to A
+	cmp #$ff							; Check if below zero
+	bne looprc1				        	; Branch for outer loop if not yet below zero
 
 	jsr RestoreMMUandZP					; Restore MU/ZP
 	rts
@@ -715,18 +774,19 @@ _VDC_FillArea_core:
 ;			VDC_tmp2 = length value
 ;			VDC_tmp3 = attribute value
 ;			VDC_tmp4 = number of lines
+;			VDC_linestride = characters per line on screen
 ; ------------------------------------------------------------------------------------------
 
 loopdrawline:
 	jsr _VDC_HChar_core					; Draw line
 
-	; Increase start address with 80 for next line
+	; Increase start address with line stride for next line
 	clc 								; Clear carry
 	lda _VDC_addrl	        			; Load low byte of address to A
-	adc #$50    						; Add 80 with carry
+	adc _VDC_linestride					; Add low byte of line stride
 	sta _VDC_addrl			        	; Store result back
 	lda _VDC_addrh	        			; Load high byte of address to A
-	adc #$00    						; Add 0 with carry
+	adc _VDC_linestride+1				; Add high byte of line stride
 	sta _VDC_addrh	        			; Store result back
 
 	; Decrease line counter and loop until zero
@@ -746,6 +806,7 @@ _VDC_CopyViewPortToVDC_core:
 ;			VDC_tmp1 = number lines to copy
 ;			VDC_tmp2 = length per line to copy
 ;			VDC_tmp3 = MMU config of source
+;			VDC_linestride = characters per line on screen
 ; ------------------------------------------------------------------------------------------
 
 	jsr SaveMMUandZP					; Safeguard MMU/ZP and set MMU
@@ -757,10 +818,7 @@ _VDC_CopyViewPortToVDC_core:
 	sta $fc								; Store high byte in pointer
 
 	; Start of copy loop
-	ldy #$00    						; Set Y as counter on 0
 outerloopvp:							; Start of outer loop
-	lda _VDC_tmp2						; Load length of line
-	sta _VDC_tmp4						; Store length to counter
 
 	; Hi-byte of the source VDC address to register 18
 	ldx #$12    						; Load $12 for register 18 (VDC RAM address high) in X	
@@ -772,21 +830,18 @@ outerloopvp:							; Start of outer loop
 	lda _VDC_destl      				; Load low byte of address in A
 	jsr VDC_Write						; Write VDC
 
-	; Read value and store at VDC address
-copyloopvp:								; Start of copy loop
-	lda ($fb),y							; Load source data
-	ldx #$1f    						; Load $1f for register 31 (VDC data) in X
-	jsr VDC_Write						; Write VDC
+	; Stream line to VDC (VDC auto increments)
+	ldx #$00							; No full pages for a single line
+	jsr VDC_WriteStream					; Stream data to VDC
 
-	; Increase source address (VDC auto increments)
-	inc $fb								; Increment low byte of source address
-	bne nextvp1							; If not yet zero, branch to next label
+	; Add line length to source address
+	sec									; Set carry to add length plus one
+	lda $fb								; Load low byte of source address
+	adc _VDC_tmp2						; Add line length
+	sta $fb								; Store low byte of source address
+	bcc nextvp1							; Skip if no carry
 	inc $fc								; Increment high byte of source address
 nextvp1:								; Next label
-	dec _VDC_tmp4						; Decrease counter for line
-	lda _VDC_tmp4						; Load counter to A
-	cmp #$ff							; Check if below zero
-	bne copyloopvp						; Continue loop if not yet below zero
 
 	; Add stride to addresses for next line
 	clc									; Clear carry
@@ -798,10 +853,10 @@ nextvp1:								; Next label
 	sta $fc								; Store high byte of source address
 	clc									; Clear carry
 	lda _VDC_destl						; Load low byte of VDC destination
-	adc #$50							; Add 80 characters for next line
+	adc _VDC_linestride					; Add low byte of line stride
 	sta _VDC_destl						; Store low byte of VDC destination
 	lda _VDC_desth						; Load high byte of VDC destination
-	adc #$00							; Add 0 with carry
+	adc _VDC_linestride+1				; Add high byte of line stride
 	sta _VDC_desth						; Store high byte of VDC destination
 	dec _VDC_tmp1						; Decrease counter number of lines
 	lda _VDC_tmp1						; Load counter to A
@@ -818,6 +873,8 @@ _VDC_ScrollCopy_core:
 ;			VDC_addrl = low byte of source address
 ;			VDC_desth = high byte of destination address
 ;			VDC_destl = low byte of destination address
+;			VDC_strideh = high byte of line step (80 for top to bottom, -80 for bottom to top)
+;			VDC_stridel = low byte of line step
 ;			VDC_tmp1 = number of lines to copy
 ;			VDC_tmp2 = length per line to copy
 ; ------------------------------------------------------------------------------------------
@@ -853,23 +910,23 @@ loopscrollcpy:
 	lda _VDC_tmp2		        		; Set length
 	jsr VDC_Write						; Write VDC
 
-	; Increase destination address for one line
+	; Add line step to destination address
 	clc									; Clear carry
 	lda _VDC_destl		        		; Load low byte of destination
-	adc #$50							; Add 80 charachters for next line
+	adc _VDC_stridel					; Add low byte of line step
 	sta _VDC_destl						; Store low byte of destination
 	lda _VDC_desth						; Load high byte of destination
-	adc #$00							; Add 0 to add carry if needed
+	adc _VDC_strideh					; Add high byte of line step
 	sta _VDC_desth						; Store high byte of destination
 
-	; Increase source address for one line
+	; Add line step to source address
 	clc									; Clear carry
-	lda _VDC_addrl		        		; Load low byte of destination
-	adc #$50							; Add 80 charachters for next line
-	sta _VDC_addrl						; Store low byte of destination
-	lda _VDC_addrh						; Load high byte of destination
-	adc #$00							; Add 0 to add carry if needed
-	sta _VDC_addrh						; Store high byte of destination	
+	lda _VDC_addrl		        		; Load low byte of source
+	adc _VDC_stridel					; Add low byte of line step
+	sta _VDC_addrl						; Store low byte of source
+	lda _VDC_addrh						; Load high byte of source
+	adc _VDC_strideh					; Add high byte of line step
+	sta _VDC_addrh						; Store high byte of source
 
 	; Decrease line counter and loop until last page
 	dec _VDC_tmp1		        		; Decrease line counter
@@ -891,56 +948,57 @@ _SetLoadSaveBank_core:
 	rts
 
 ; ------------------------------------------------------------------------------------------
-_POKEB_core:
-; Function to poke to a memory position in specified bank
-; Input:	VDC_addrh and VDC_addrl:	high and low byte of address to poke
-;			VDC_tmp3:					MMU config for poke
-;			VDC_value:					value to poke
+_POKEB:
+; Function to poke to a memory position in specified bank (fastcall)
+; Input:	A = value to poke
+;			C stack: bank number (0-3), address
 ; ------------------------------------------------------------------------------------------
 
-	jsr SaveMMUandZP					; Safeguard MMU/ZP and set MMU
-
-	; Set address pointer in zero-page
-	lda _VDC_addrl						; Obtain low byte in A
-	sta $fb								; Store low byte in pointer
-	lda _VDC_addrh						; Obtain high byte in A
-	sta $fc								; Store high byte in pointer
-
-	; Store value in specified address
-	ldy #$00							; Clear Y index
-	lda _VDC_value						; Load value in A
-	sta ($fb),y							; Store at destination
-
-	jsr RestoreMMUandZP					; Restore MU/ZP
-    rts
+	pha									; Keep value to poke on stack
+	jsr popa							; Obtain bank number
+	tay									; Bank number as index in Y
+	lda _bankconfig,y					; Obtain MMU config for bank
+	sta _VDC_tmp3						; Store MMU config
+	jsr popax							; Obtain address, low byte in A and high byte in X
+	sta pokebaddress+1					; Patch low byte of store instruction
+	stx pokebaddress+2					; Patch high byte of store instruction
+	ldy $ff00							; Safeguard present memory configuration in Y
+	lda _VDC_tmp3						; Obtain selected MMU config
+	sta $ff00							; Set selected MMU config
+	pla									; Get value to poke
+pokebaddress:							; Store instruction with patched address
+	sta $ffff							; Store value at address
+	sty $ff00							; Restore memory configuration
+	rts
 
 ; ------------------------------------------------------------------------------------------
-_PEEKB_core:
-; Function to peek a memory position in specified bank
-; Input:	VDC_addrh and VDC_addrl:	high and low byte of address to peek
-;			VDC_tmp3:					MMU config for peek
-; Output:	VDC_value:					value peeked at address
+_PEEKB:
+; Function to peek a memory position in specified bank (fastcall)
+; Input:	A = bank number (0-3)
+;			C stack: address
+; Output:	A = value peeked at address, X = 0
 ; ------------------------------------------------------------------------------------------
 
-	jsr SaveMMUandZP					; Safeguard MMU/ZP and set MMU
-
-	; Set address pointer in zero-page
-	lda _VDC_addrl						; Obtain low byte in A
-	sta $fb								; Store low byte in pointer
-	lda _VDC_addrh						; Obtain high byte in A
-	sta $fc								; Store high byte in pointer
-
-	; Store value in specified address
-	ldy #$00							; Clear Y index
-	lda ($fb),y							; Load value from source address
-	sta _VDC_value						; Store value in variable to return
-
-	jsr RestoreMMUandZP					; Restore MU/ZP
-    rts
+	tay									; Bank number as index in Y
+	lda _bankconfig,y					; Obtain MMU config for bank
+	sta _VDC_tmp3						; Store MMU config
+	jsr popax							; Obtain address, low byte in A and high byte in X
+	sta peekbaddress+1					; Patch low byte of load instruction
+	stx peekbaddress+2					; Patch high byte of load instruction
+	ldy $ff00							; Safeguard present memory configuration in Y
+	lda _VDC_tmp3						; Obtain selected MMU config
+	sta $ff00							; Set selected MMU config
+peekbaddress:							; Load instruction with patched address
+	lda $ffff							; Load value from address
+	sty $ff00							; Restore memory configuration
+	ldx #$00							; Clear high byte of return value
+	rts
 
 ; ------------------------------------------------------------------------------------------
 _BankMemCopy_core:
 ; Function to copy memory to another place in memory which user defined banks
+; Copies one page at a time via a staging buffer in shared low RAM ($D506 set by VDC_Init),
+; so MMU config only has to be switched once per page for source and for destination
 ; Input:	VDC_addrh = high byte of source address
 ;			VDC_addrl = low byte of source address
 ;			VDC_desth = high byte of VDC destination address
@@ -971,43 +1029,46 @@ _BankMemCopy_core:
 	lda _VDC_desth						; Obtain high byte in A
 	sta $fe								; Store high byte in pointer
 
-	; Start of copy loop
-	ldy #$00    						; Set Y as counter on 0
-	
-copyloopbmc:							; Start of copy loop
-	; Set MMU configuration for source
+pageloopbmc:							; Start of page loop
+	; Determine last index of this page
+	ldx #$ff							; Full page has last index $ff
+	lda _VDC_tmp1						; Load number of full pages left
+	bne fullpagebmc						; Skip if still full pages to copy
+	ldx _VDC_tmp2						; Load last index of last page
+fullpagebmc:							; Next label
+	stx BankStageLast					; Store last index of this page
+
+	; Read page from source to staging buffer
 	lda _VDC_tmp3						; Obtain selected MMU config for source
 	sta $ff00							; Store selected MMU config for source
-
-	; Read value at source address
+	ldy BankStageLast					; Set Y as counter on last index
+readloopbmc:							; Start of read loop
 	lda ($fb),y							; Load source data
-
-	; Set MMU configuration for destination
-	ldx _VDC_tmp4						; Obtain selected MMU config for source
-	stx $ff00							; Store selected MMU config for source
-
-	; Store value at destination address
-	sta ($fd),y 						; Store data at destination
-
-	; Increase addresses
-	inc $fb								; Increment low byte of source address
-	bne nextbmc1						; If not yet zero, branch to next label
+	sta _VDC_stagebuffer,y				; Store in staging buffer
+	dey									; Decrease counter
+	cpy #$ff							; Check if below zero
+	bne readloopbmc						; Continue loop if not yet below zero
+
+	; Write page from staging buffer to destination
+	lda _VDC_tmp4						; Obtain selected MMU config for destination
+	sta $ff00							; Store selected MMU config for destination
+	ldy BankStageLast					; Set Y as counter on last index
+writeloopbmc:							; Start of write loop
+	lda _VDC_stagebuffer,y				; Load data from staging buffer
+	sta ($fd),y							; Store data at destination
+	dey									; Decrease counter
+	cpy #$ff							; Check if below zero
+	bne writeloopbmc					; Continue loop if not yet below zero
+
+	; Increase addresses to next page
 	inc $fc								; Increment high byte of source address
-nextbmc1:								; Next label
-	inc $fd								; Increment low byte of source address
-	bne nextbmc2						; If not yet zero, branch to next label
-	inc $fe								; Increment high byte of source address
-nextbmc2:								; Next label
+	inc $fe								; Increment high byte of destination address
 
-	; Decrease counters
-	dec _VDC_tmp2						; Decrease low byte of length
-	lda _VDC_tmp2						; Load low byte of length to A
-	cmp #$ff							; Check if below zero
-	bne copyloopbmc						; Continue loop if not yet below zero
+	; Decrease page counter
 	dec _VDC_tmp1						; Decrease high byte of length
 	lda _VDC_tmp1						; Load high byte of length to A
 	cmp #$ff							; Check if below zero
-	bne copyloopbmc						; Continue loop if not yet below zero
+	bne pageloopbmc						; Continue loop if not yet below zero
 
 ; Restore ZP addresses
 	lda ZPtmp3							; Obtain stored value of $fd
@@ -1062,4 +1123,711 @@ nextbms1:								; Next label
 	bne copyloopbms						; Continue loop if not yet below zero
 
 	jsr RestoreMMUandZP					; Restore MU/ZP
-    rts
\ No newline at end of file
+    rts
+
+; ------------------------------------------------------------------------------------------
+_BankRectCopy_core:
+; Function to copy a rectangle to another place within a user defined bank
+; Pitches are added per row, so a negative pitch walks the rows from the bottom up
+; Input:	VDC_addrh/VDC_addrl = source address of first row to copy
+;			VDC_desth/VDC_destl = destination address of first row to copy
+;			VDC_strideh/VDC_stridel = source pitch to add per row
+;			VDC_destpitch = destination pitch to add per row
+;			VDC_rows = number of rows to copy
+;			VDC_tmp2 = low byte of width
+;			VDC_tmp4 = high byte of width
+;			VDC_tmp3 = MMU config
+;			VDC_value = 0 to copy rows forward, 1 to copy rows backward
+; ------------------------------------------------------------------------------------------
+
+	jsr SaveMMUandZP					; Safeguard MMU/ZP and set MMU
+
+	; Store $FD and $FE addresses for safety to be restored at exit
+	lda $fd								; Obtain present value at $fd
+	sta ZPtmp3							; Store to be restored later
+	lda $fe								; Obtain present value at $fe
+	sta ZPtmp4							; Store to be restored later
+
+rowloopbrc:								; Start of row loop
+	; Set row pointers in zero-page
+	lda _VDC_addrl						; Obtain low byte of source row
+	sta $fb								; Store low byte in pointer
+	lda _VDC_addrh						; Obtain high byte of source row
+	sta $fc								; Store high byte in pointer
+	lda _VDC_destl						; Obtain low byte of destination row
+	sta $fd								; Store low byte in pointer
+	lda _VDC_desth						; Obtain high byte of destination row
+	sta $fe								; Store high byte in pointer
+	ldx _VDC_tmp4						; Load number of full pages in row
+	lda _VDC_value						; Load direction
+	bne backwardbrc						; Branch if row has to be copied backward
+
+	; Copy row forward
+	ldy #$00							; Set Y as index on 0
+	cpx #$00							; Check if full pages are to be copied
+	beq fwdlastbrc						; Skip to last part if not
+fwdpagebrc:								; Start of full page loop
+	lda ($fb),y							; Load source data
+	sta ($fd),y							; Store data at destination
+	iny									; Increase index
+	bne fwdpagebrc						; Continue until page is complete
+	inc $fc								; Increase high byte of source pointer
+	inc $fe								; Increase high byte of destination pointer
+	dex									; Decrease page counter
+	bne fwdpagebrc						; Continue until all full pages are copied
+fwdlastbrc:								; Start of loop for last part of row
+	cpy _VDC_tmp2						; Check if end of row is reached
+	beq nextrowbrc						; Next row if end is reached
+	lda ($fb),y							; Load source data
+	sta ($fd),y							; Store data at destination
+	iny									; Increase index
+	bne fwdlastbrc						; Continue loop (always taken)
+
+backwardbrc:							; Copy row backward, starting at the end
+	txa									; Number of full pages to A
+	clc									; Clear carry for addition
+	adc $fc								; Add to high byte of source pointer
+	sta $fc								; Store high byte of source pointer
+	txa									; Number of full pages to A
+	clc									; Clear carry for addition
+	adc $fe								; Add to high byte of destination pointer
+	sta $fe								; Store high byte of destination pointer
+	ldy _VDC_tmp2						; Set Y as index on end of last part
+	beq bwdpagesbrc						; Skip if no last part
+bwdlastbrc:								; Start of loop for last part of row
+	dey									; Decrease index
+	lda ($fb),y							; Load source data
+	sta ($fd),y							; Store data at destination
+	cpy #$00							; Check if start of part is reached
+	bne bwdlastbrc						; Continue loop if not
+bwdpagesbrc:							; Start of full page loop
+	cpx #$00							; Check if full pages are left
+	beq nextrowbrc						; Next row if not
+	dec $fc								; Decrease high byte of source pointer
+	dec $fe								; Decrease high byte of destination pointer
+bwdpagebrc:								; Start of loop within page
+	dey									; Decrease index
+	lda ($fb),y							; Load source data
+	sta ($fd),y							; Store data at destination
+	cpy #$00							; Check if start of page is reached
+	bne bwdpagebrc						; Continue loop if not
+	dex									; Decrease page counter
+	jmp bwdpagesbrc						; Next page
+
+nextrowbrc:								; Advance to next row
+	clc									; Clear carry for addition
+	lda _VDC_addrl						; Load low byte of source row
+	adc _VDC_stridel					; Add low byte of source pitch
+	sta _VDC_addrl						; Store low byte of source row
+	lda _VDC_addrh						; Load high byte of source row
+	adc _VDC_strideh					; Add high byte of source pitch
+	sta _VDC_addrh						; Store high byte of source row
+	clc									; Clear carry for addition
+	lda _VDC_destl						; Load low byte of destination row
+	adc _VDC_destpitch					; Add low byte of destination pitch
+	sta _VDC_destl						; Store low byte of destination row
+	lda _VDC_desth						; Load high byte of destination row
+	adc _VDC_destpitch+1				; Add high byte of destination pitch
+	sta _VDC_desth						; Store high byte of destination row
+	jsr DecreaseRows					; Decrease row counter
+	bne rowloopbrc						; Continue until all rows are copied
+
+	; Restore ZP addresses
+	lda ZPtmp3							; Obtain stored value of $fd
+	sta $fd								; Restore value
+	lda ZPtmp4							; Obtain stored value of $fe
+	sta $fe								; Restore value
+
+	jsr RestoreMMUandZP					; Restore MMU/ZP
+	rts
+
+; ------------------------------------------------------------------------------------------
+_BankRectSet_core:
+; Function to set a rectangle in a user defined bank to a specific value
+; Input:	VDC_addrh/VDC_addrl = address of first row
+;			VDC_strideh/VDC_stridel = pitch to add per row
+;			VDC_rows = number of rows to set
+;			VDC_tmp2 = low byte of width
+;			VDC_tmp4 = high byte of width
+;			VDC_tmp3 = MMU config
+;			VDC_value = value to set
+; ------------------------------------------------------------------------------------------
+
+	jsr SaveMMUandZP					; Safeguard MMU/ZP and set MMU
+
+rowloopbrs:								; Start of row loop
+	lda _VDC_addrl						; Obtain low byte of row
+	sta $fb								; Store low byte in pointer
+	lda _VDC_addrh						; Obtain high byte of row
+	sta $fc								; Store high byte in pointer
+	ldx _VDC_tmp4						; Load number of full pages in row
+	ldy #$00							; Set Y as index on 0
+	lda _VDC_value						; Load value to set
+	cpx #$00							; Check if full pages are to be set
+	beq lastbrs							; Skip to last part if not
+pagebrs:								; Start of full page loop
+	sta ($fb),y							; Store value
+	iny									; Increase index
+	bne pagebrs							; Continue until page is complete
+	inc $fc								; Increase high byte of pointer
+	dex									; Decrease page counter
+	bne pagebrs							; Continue until all full pages are set
+lastbrs:								; Start of loop for last part of row
+	cpy _VDC_tmp2						; Check if end of row is reached
+	beq nextrowbrs						; Next row if end is reached
+	sta ($fb),y							; Store value
+	iny									; Increase index
+	bne lastbrs							; Continue loop (always taken)
+nextrowbrs:								; Advance to next row
+	clc									; Clear carry for addition
+	lda _VDC_addrl						; Load low byte of row
+	adc _VDC_stridel					; Add low byte of pitch
+	sta _VDC_addrl						; Store low byte of row
+	lda _VDC_addrh						; Load high byte of row
+	adc _VDC_strideh					; Add high byte of pitch
+	sta _VDC_addrh						; Store high byte of row
+	jsr DecreaseRows					; Decrease row counter
+	bne rowloopbrs						; Continue until all rows are set
+
+	jsr RestoreMMUandZP					; Restore MMU/ZP
+	rts
+
+; ------------------------------------------------------------------------------------------
+_BankRectTransform_core:
+; Function to replace every byte in a rectangle in a user defined bank via a lookup table
+; Input:	VDC_addrh/VDC_addrl = address of first row
+;			VDC_strideh/VDC_stridel = pitch to add per row
+;			VDC_rows = number of rows to transform
+;			VDC_tmp2 = low byte of width
+;			VDC_tmp4 = high byte of width
+;			VDC_tmp3 = MMU config
+;			VDC_stagebuffer = 256 byte lookup table with new value per old value
+; ------------------------------------------------------------------------------------------
+
+	jsr SaveMMUandZP					; Safeguard MMU/ZP and set MMU
+
+rowloopbrt:								; Start of row loop
+	lda _VDC_addrl						; Obtain low byte of row
+	sta $fb								; Store low byte in pointer
+	lda _VDC_addrh						; Obtain high byte of row
+	sta $fc								; Store high byte in pointer
+	ldy #$00							; Set Y as index on 0
+	lda _VDC_tmp4						; Load number of full pages in row
+	sta _VDC_tmp1						; Store as page counter
+	beq lastbrt							; Skip to last part if no full pages
+pagebrt:								; Start of full page loop
+	lda ($fb),y							; Load old value
+	tax									; Old value as index in X
+	lda _VDC_stagebuffer,x				; Look up new value
+	sta ($fb),y							; Store new value
+	iny									; Increase index
+	bne pagebrt							; Continue until page is complete
+	inc $fc								; Increase high byte of pointer
+	dec _VDC_tmp1						; Decrease page counter
+	bne pagebrt							; Continue until all full pages are done
+lastbrt:								; Start of loop for last part of row
+	cpy _VDC_tmp2						; Check if end of row is reached
+	beq nextrowbrt						; Next row if end is reached
+	lda ($fb),y							; Load old value
+	tax									; Old value as index in X
+	lda _VDC_stagebuffer,x				; Look up new value
+	sta ($fb),y							; Store new value
+	iny									; Increase index
+	bne lastbrt							; Continue loop (always taken)
+nextrowbrt:								; Advance to next row
+	clc									; Clear carry for addition
+	lda _VDC_addrl						; Load low byte of row
+	adc _VDC_stridel					; Add low byte of pitch
+	sta _VDC_addrl						; Store low byte of row
+	lda _VDC_addrh						; Load high byte of row
+	adc _VDC_strideh					; Add high byte of pitch
+	sta _VDC_addrh						; Store high byte of row
+	jsr DecreaseRows					; Decrease row counter
+	bne rowloopbrt						; Continue until all rows are done
+
+	jsr RestoreMMUandZP					; Restore MMU/ZP
+	rts
+
+; ------------------------------------------------------------------------------------------
+DecreaseRows:
+; Function to decrease the 16 bit row counter of the rectangle routines
+; Output:	Z flag set if no rows are left
+; ------------------------------------------------------------------------------------------
+
+	lda _VDC_rows						; Load low byte of row counter
+	bne decreaserowslow					; Skip borrow if low byte is not zero
+	dec _VDC_rows+1						; Decrease high byte for borrow
+decreaserowslow:						; Next label
+	dec _VDC_rows						; Decrease low byte of row counter
+	lda _VDC_rows						; Load low byte of row counter
+	ora _VDC_rows+1						; Combine with high byte to test for zero
+	rts
+
+; ==========================================================================================
+; Routines without bank switching: placed in main code to keep MACO space for bank routines
+; ==========================================================================================
+
+.segment	"CODE"
+
+; ------------------------------------------------------------------------------------------
+_VDC_Poke:
+; Function to store a value to a VDC address (fastcall)
+; Input:	A = value to write
+;			C stack: VDC address
+; ------------------------------------------------------------------------------------------
+
+	pha									; Keep value to write on stack
+	jsr popax							; Obtain address, low byte in A and high byte in X
+	tay									; Keep low byte of address in Y
+	txa									; High byte of address in A
+    ldx #$12                            ; Load $12 for register 18 (VDC RAM address high) in X	
+	jsr VDC_Write						; Write VDC
+	inx		    						; Increase X for register 19 (VDC RAM address low)
+	tya				      				; Load low byte of address in A
+	jsr VDC_Write						; Write VDC
+	ldx #$1f    						; Load $1f for register 31 (VDC data) in X	
+	pla				       				; Get value to write
+	jsr VDC_Write						; Write VDC
+    rts
+
+; ------------------------------------------------------------------------------------------
+_VDC_Plot:
+; Function to plot a screencode and attribute at a row and column of the screen (fastcall)
+; Input:	A = attribute
+;			C stack: screencode, column, row
+;			VDC_rowaddress and VDC_attroffset for screen layout
+; ------------------------------------------------------------------------------------------
+
+	sta _VDC_tmp3						; Store attribute
+	jsr popa							; Obtain screencode
+	sta _VDC_value						; Store screencode
+	jsr popa							; Obtain column
+	sta _VDC_addrl						; Store column as low byte of address
+	jsr popa							; Obtain row
+	asl									; Row times two as index in word table
+	tay									; Index to Y
+
+	; Add row address from table to column
+	clc									; Clear carry
+	lda _VDC_rowaddress,y				; Load low byte of row address
+	adc _VDC_addrl						; Add column
+	sta _VDC_addrl						; Store low byte of address
+	lda _VDC_rowaddress+1,y				; Load high byte of row address
+	adc #$00							; Add carry
+	sta _VDC_addrh						; Store high byte of address
+
+	; Write screencode
+    ldx #$12                            ; Load $12 for register 18 (VDC RAM address high) in X	
+	lda _VDC_addrh                      ; Load high byte of address in A
+	jsr VDC_Write						; Write VDC
+	inx		    						; Increase X for register 19 (VDC RAM address low)
+	lda _VDC_addrl      				; Load low byte of address in A
+	jsr VDC_Write						; Write VDC
+	ldx #$1f    						; Load $1f for register 31 (VDC data) in X	
+	lda _VDC_value       				; Load screencode in A
+	jsr VDC_Write						; Write VDC
+
+	; Write attribute
+	clc									; Clear carry
+	lda _VDC_addrl						; Load low byte of address
+	adc _VDC_attroffset					; Add low byte of attribute offset
+	tay									; Keep low byte of attribute address in Y
+	lda _VDC_addrh						; Load high byte of address
+	adc _VDC_attroffset+1				; Add high byte of attribute offset
+    ldx #$12                            ; Load $12 for register 18 (VDC RAM address high) in X	
+	jsr VDC_Write						; Write VDC
+	inx		    						; Increase X for register 19 (VDC RAM address low)
+	tya				      				; Load low byte of attribute address in A
+	jsr VDC_Write						; Write VDC
+	ldx #$1f    						; Load $1f for register 31 (VDC data) in X	
+	lda _VDC_tmp3       				; Load attribute in A
+	jsr VDC_Write						; Write VDC
+    rts
+
+; ------------------------------------------------------------------------------------------
+_VDC_WaitVBlank:
+; Function to wait for the start of the VDC vertical blank
+; Uses vertical blank status bit 5 of the VDC address/status register
+; ------------------------------------------------------------------------------------------
+
+vblankwaitend:							; Wait for end of a vertical blank already in progress
+	lda VDC_ADDRESS_REGISTER			; Load VDC status
+	and #$20							; Isolate vertical blank bit
+	bne vblankwaitend					; Continue loop while in vertical blank
+vblankwaitstart:						; Wait for start of next vertical blank
+	lda VDC_ADDRESS_REGISTER			; Load VDC status
+	and #$20							; Isolate vertical blank bit
+	beq vblankwaitstart					; Continue loop until vertical blank starts
+	rts
+
+; ------------------------------------------------------------------------------------------
+_VDC_FillBlock_core:
+; Function to fill a contiguous block of VDC memory with chained hardware fills
+; Input:	VDC_addrh = high byte of start address
+;			VDC_addrl = low byte of start address
+;			VDC_value = value to fill with
+;			VDC_tmp1 = number of full 256 byte fills after the first byte
+;			VDC_tmp2 = length of last fill
+; ------------------------------------------------------------------------------------------
+
+	; Set start address and write first byte
+	ldx #$12    						; Load $12 for register 18 (VDC RAM address high) in X	
+	lda _VDC_addrh	        			; Load high byte of start in A
+	jsr VDC_Write						; Write VDC
+	inx 								; Increase X for register 19 (VDC RAM address low)
+	lda _VDC_addrl		        		; Load low byte of start in A
+	jsr VDC_Write						; Write VDC
+	ldx #$1f    						; Load $1f for register 31 (VDC data) in X	
+	lda _VDC_value			        	; Load fill value in A
+	jsr VDC_Write						; Write VDC
+
+	; Clear the copy bit (bit 7) of register 24 (block copy mode)
+	ldx #$18    						; Load $18 for register 24 (block copy mode) in X	
+	lda #$00				        	; Load 0 in A
+	jsr VDC_Write						; Write VDC
+
+	; Full 256 byte fills, each continues where the previous ended
+	ldx #$1e    						; Load $1e for register 30 (word count) in X	
+	ldy _VDC_tmp1						; Load number of full fills in Y
+	beq fillblocklast					; Skip if none
+fillblockloop:							; Start of full fill loop
+	lda #$00							; Word count 0 fills 256 bytes
+	jsr VDC_Write						; Write VDC
+	dey									; Decrease counter
+	bne fillblockloop					; Continue until all full fills done
+fillblocklast:							; Last fill
+	lda _VDC_tmp2						; Load length of last fill
+	beq fillblockend					; Skip if nothing left
+	jsr VDC_Write						; Write VDC
+fillblockend:							; End of routine
+	rts
+
+; ------------------------------------------------------------------------------------------
+_BankMemCopy:
+; Function to copy memory between user defined banks (fastcall entry for BankMemCopy_core)
+; Input:	A/X = length in bytes (low/high)
+;			C stack: destination bank, destination address, source bank, source address
+; ------------------------------------------------------------------------------------------
+
+	sec									; Set carry for subtraction
+	sbc #$01							; Length minus one for count down loop
+	sta _VDC_tmp2						; Store length in last page
+	bcs bmcnoborrow						; Skip if no borrow
+	dex									; Decrease high byte for borrow
+bmcnoborrow:							; Next label
+	stx _VDC_tmp1						; Store number of pages
+	jsr popa							; Obtain destination bank
+	tay									; Bank number as index in Y
+	lda _bankconfig,y					; Obtain MMU config for bank
+	sta _VDC_tmp4						; Store MMU config of destination
+	jsr popax							; Obtain destination address
+	sta _VDC_destl						; Store low byte of destination
+	stx _VDC_desth						; Store high byte of destination
+	jsr popa							; Obtain source bank
+	tay									; Bank number as index in Y
+	lda _bankconfig,y					; Obtain MMU config for bank
+	sta _VDC_tmp3						; Store MMU config of source
+	jsr popax							; Obtain source address
+	sta _VDC_addrl						; Store low byte of source
+	stx _VDC_addrh						; Store high byte of source
+	jmp _BankMemCopy_core				; Copy in shared memory routine
+
+; ------------------------------------------------------------------------------------------
+_VDC_RunCommands_core:
+; Function to execute a VDC command list in one call
+; Input:	VDC_addrh = high byte of command list address (bank 0)
+;			VDC_addrl = low byte of command list address (bank 0)
+; Command list format (VDC addresses high byte first, lengths minus one unless noted):
+;			$00 = END
+;			$01 = SETREG	register, value
+;			$02 = FILL		address, value, length-1
+;			$03 = PLOT		address, value
+;			$04 = STRING	address, length-1, bytes
+;			$05 = COPY		address, length-1, source low, source high (bank 0)
+;			$06 = BLOCKCOPY	destination address, source address, length (0 = 256)
+; ------------------------------------------------------------------------------------------
+
+	; Store $fb to $fe addresses for safety to be restored at exit
+	lda $fb								; Obtain present value at $fb
+	sta ZPtmp1							; Store to be restored later
+	lda $fc								; Obtain present value at $fc
+	sta ZPtmp2							; Store to be restored later
+	lda $fd								; Obtain present value at $fd
+	sta ZPtmp3							; Store to be restored later
+	lda $fe								; Obtain present value at $fe
+	sta ZPtmp4							; Store to be restored later
+
+	; Set command list pointer in zero-page
+	lda _VDC_addrl						; Obtain low byte in A
+	sta $fb								; Store low byte in pointer
+	lda _VDC_addrh						; Obtain high byte in A
+	sta $fc								; Store high byte in pointer
+
+cmdloop:								; Start of command loop
+	ldy #$00							; Pointer is at opcode of next command
+	lda ($fb),y							; Load opcode
+	bne cmdnotend						; Continue if not END
+	jmp cmdend							; Jump to end of list
+cmdnotend:								; Next label
+	iny									; Next byte of command
+	cmp #$01							; Check for SETREG
+	bne cmdaddress						; All other commands start with a VDC address
+
+	; SETREG: write value to register
+	lda ($fb),y							; Load register number
+	tax									; Register number in X
+	iny									; Next byte of command
+	lda ($fb),y							; Load register value
+	iny									; Next byte of command
+	jsr VDC_Write						; Write VDC
+	jmp cmdnext							; Next command
+
+cmdaddress:								; Set VDC address for command
+	sta _VDC_tmp4						; Keep opcode
+	ldx #$12    						; Load $12 for register 18 (VDC RAM address high) in X	
+	lda ($fb),y							; Load high byte of address
+	iny									; Next byte of command
+	jsr VDC_Write						; Write VDC
+	inx 								; Increase X for register 19 (VDC RAM address low)
+	lda ($fb),y							; Load low byte of address
+	iny									; Next byte of command
+	jsr VDC_Write						; Write VDC
+	lda _VDC_tmp4						; Get opcode back
+
+	; PLOT: write single value
+	cmp #$03							; Check for PLOT
+	bne cmdnotplot						; Skip if not PLOT
+	ldx #$1f    						; Load $1f for register 31 (VDC data) in X	
+	lda ($fb),y							; Load value
+	iny									; Next byte of command
+	jsr VDC_Write						; Write VDC
+	jmp cmdnext							; Next command
+
+cmdnotplot:								; Next label
+	; FILL: write first value and let the VDC fill the rest
+	cmp #$02							; Check for FILL
+	bne cmdnotfill						; Skip if not FILL
+	ldx #$1f    						; Load $1f for register 31 (VDC data) in X	
+	lda ($fb),y							; Load value
+	iny									; Next byte of command
+	jsr VDC_Write						; Write VDC
+	ldx #$18    						; Load $18 for register 24 (block copy mode) in X	
+	lda #$00				        	; Clear copy bit for fill
+	jsr VDC_Write						; Write VDC
+	ldx #$1e    						; Load $1e for register 30 (word count) in X	
+	lda ($fb),y							; Load length minus one
+	iny									; Next byte of command
+	jsr VDC_Write						; Write VDC
+	jmp cmdnext							; Next command
+
+cmdnotfill:								; Next label
+	; BLOCKCOPY: copy within VDC memory
+	cmp #$06							; Check for BLOCKCOPY
+	bne cmdnotblock						; Skip if not BLOCKCOPY
+	ldx #$18    						; Load $18 for register 24 (block copy mode) in X	
+	lda #$80				        	; Set copy bit for block copy
+	jsr VDC_Write						; Write VDC
+	ldx #$20    						; Load $20 for register 32 (block copy source high) in X	
+	lda ($fb),y							; Load high byte of source
+	iny									; Next byte of command
+	jsr VDC_Write						; Write VDC
+	inx 								; Increase X for register 33 (block copy source low)
+	lda ($fb),y							; Load low byte of source
+	iny									; Next byte of command
+	jsr VDC_Write						; Write VDC
+	ldx #$1e    						; Load $1e for register 30 (word count) in X	
+	lda ($fb),y							; Load length
+	iny									; Next byte of command
+	jsr VDC_Write						; Write VDC
+	jmp cmdnext							; Next command
+
+cmdnotblock:							; STRING or COPY: stream bytes from bank 0
+	tax									; Keep opcode in X
+	lda ($fb),y							; Load length minus one
+	sta _VDC_tmp2						; Store as last index to stream
+	iny									; Next byte of command
+	cpx #$04							; Check for STRING
+	bne cmdcopy							; Skip if COPY
+
+	; STRING: data follows inline, next command follows data
+	tya									; Offset of data in A
+	clc									; Clear carry
+	adc $fb								; Add low byte of list pointer
+	sta $fd								; Store low byte of data pointer
+	lda $fc								; Load high byte of list pointer
+	adc #$00							; Add carry
+	sta $fe								; Store high byte of data pointer
+	sec									; Set carry to add length plus one
+	lda $fd								; Load low byte of data pointer
+	adc _VDC_tmp2						; Add length
+	sta $fb								; Store as low byte of next command
+	lda $fe								; Load high byte of data pointer
+	adc #$00							; Add carry
+	sta $fc								; Store as high byte of next command
+	jmp cmdstream						; Stream data
+
+cmdcopy:								; COPY: data pointer in command
+	lda ($fb),y							; Load low byte of source
+	sta $fd								; Store low byte of data pointer
+	iny									; Next byte of command
+	lda ($fb),y							; Load high byte of source
+	sta $fe								; Store high byte of data pointer
+	iny									; Next byte of command
+	tya									; Command length in A
+	clc									; Clear carry
+	adc $fb								; Add to low byte of list pointer
+	sta $fb								; Store low byte of next command
+	bcc cmdstream						; Skip if no carry
+	inc $fc								; Increment high byte of next command
+
+cmdstream:								; Stream data to VDC data register
+	lda #$1f							; Load $1f for register 31 (VDC data)
+	sta VDC_ADDRESS_REGISTER			; Select data register once, VDC auto increments
+	ldy #$00							; Start at first byte
+cmdstreamloop:							; Start of stream loop
+	lda ($fd),y							; Load byte
+cmdstreamwait:							; Start of wait loop to wait for VDC status ready
+	bit VDC_ADDRESS_REGISTER			; Check status bit 7 of VDC address register
+	bpl cmdstreamwait					; Continue loop if status is not ready
+	sta VDC_DATA_REGISTER				; Store byte in VDC data register
+	cpy _VDC_tmp2						; Check if last byte
+	beq cmdstreamend					; End stream if last byte
+	iny									; Next byte
+	bne cmdstreamloop					; Loop until 256 bytes
+cmdstreamend:							; End of stream
+	jmp cmdloop							; Pointer already at next command
+
+cmdnext:								; Move pointer to next command
+	tya									; Command length in A
+	clc									; Clear carry
+	adc $fb								; Add to low byte of list pointer
+	sta $fb								; Store low byte of list pointer
+	bcc cmdnext2						; Skip if no carry
+	inc $fc								; Increment high byte of list pointer
+cmdnext2:								; Next label
+	jmp cmdloop							; Next command
+
+cmdend:									; End of command list
+	; Restore $fb to $fe
+	lda ZPtmp1							; Obtain stored value of $fb
+	sta $fb								; Restore value
+	lda ZPtmp2							; Obtain stored value of $fc
+	sta $fc								; Restore value
+	lda ZPtmp3							; Obtain stored value of $fd
+	sta $fd								; Restore value
+	lda ZPtmp4							; Obtain stored value of $fe
+	sta $fe								; Restore value
+	rts
+
+; ------------------------------------------------------------------------------------------
+_VDC_PetsciiToScreenCode:
+; Function to convert PETSCII value to screencode (fastcall)
+; Input:	A = PETSCII value
+; Output:	A = screencode, X = 0
+; ------------------------------------------------------------------------------------------
+
+	tax									; PETSCII value as index in X
+	lda _VDC_PetsciiToScreenCodeTable,x	; Translate via table
+	ldx #$00							; Clear high byte of return value
+	rts
+
+; ------------------------------------------------------------------------------------------
+_VDC_PetsciiToScreenCodeRvs:
+; Function to convert PETSCII value to reversed screencode (fastcall)
+; Input:	A = PETSCII value
+; Output:	A = screencode, X = 0
+; ------------------------------------------------------------------------------------------
+
+	tax									; PETSCII value as index in X
+	lda _VDC_PetsciiToScreenCodeRvsTable,x	; Translate via table
+	ldx #$00							; Clear high byte of return value
+	rts
+
+; ------------------------------------------------------------------------------------------
+_VDC_TranslateBuffer:
+; Function to translate a buffer in bank 0 in place via a 256 byte table (fastcall)
+; Input:	A/X = length of buffer in bytes (low/high)
+;			C stack: table address, buffer address
+; ------------------------------------------------------------------------------------------
+
+	sta _VDC_tmp2						; Store low byte of length
+	stx _VDC_tmp1						; Store high byte of length
+	jsr popax							; Obtain buffer address
+	sta translateload+1					; Patch low byte of load instruction
+	stx translateload+2					; Patch high byte of load instruction
+	sta translatestore+1				; Patch low byte of store instruction
+	stx translatestore+2				; Patch high byte of store instruction
+	jsr popax							; Obtain table address
+	sta translatetable+1				; Patch low byte of table lookup
+	stx translatetable+2				; Patch high byte of table lookup
+	ldy #$00							; Start at first byte of buffer
+
+translateloop:							; Start of translate loop
+	lda _VDC_tmp2						; Check low byte of remaining length
+	bne translatecount					; Decrease low byte if not zero
+	lda _VDC_tmp1						; Check high byte of remaining length
+	beq translateend					; End if both are zero
+	dec _VDC_tmp1						; Borrow from high byte
+translatecount:							; Next label
+	dec _VDC_tmp2						; Decrease low byte of remaining length
+translateload:							; Load instruction with patched address
+	ldx $ffff,y							; Load byte from buffer
+translatetable:							; Lookup instruction with patched address
+	lda $ffff,x							; Translate via table
+translatestore:							; Store instruction with patched address
+	sta $ffff,y							; Store translated byte in buffer
+	iny									; Next byte
+	bne translateloop					; Continue within page
+	inc translateload+2					; Next page for load
+	inc translatestore+2				; Next page for store
+	jmp translateloop					; Continue loop
+translateend:							; End of routine
+	rts
+
+; ==========================================================================================
+; Translation tables, generated at build time
+; ==========================================================================================
+
+.segment	"RODATA"
+
+; PETSCII to screencode
+_VDC_PetsciiToScreenCodeTable:
+.repeat 256, P
+	.if P < 32
+		.byte P + 128
+	.elseif P < 64
+		.byte P
+	.elseif P < 96
+		.byte P - 64
+	.elseif P < 128
+		.byte P - 32
+	.elseif P < 160
+		.byte P + 64
+	.elseif P < 192
+		.byte P - 64
+	.elseif P < 255
+		.byte P - 128
+	.else
+		.byte 94
+	.endif
+.endrepeat
+
+; PETSCII to reversed screencode
+_VDC_PetsciiToScreenCodeRvsTable:
+.repeat 256, P
+	.if P < 64
+		.byte P + 128
+	.elseif P < 96
+		.byte P + 64
+	.elseif P < 128
+		.byte P + 96
+	.elseif P < 160
+		.byte P - 128
+	.elseif P < 192
+		.byte P + 64
+	.elseif P < 255
+		.byte P
+	.else
+		.byte 94
+	.endif
+.endrepeat